@@ -266,4 +266,234 @@ TEST_CASE("TEST") {
 			threads[k].join();
 		}
 	}
+	SECTION("COMPACT TEST") {
+		AVLTree<int, int> tree;
+		int threadsAmount = 4;
+		int numberOfElements = 100;
+
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				for (int j = 0; j < numberOfElements; ++j) {
+					tree.insert({ j + th * numberOfElements, j + th * numberOfElements });
+				}
+				}, i));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		for (int i = 0; i < threadsAmount * numberOfElements; i += 3) {
+			tree.erase(i);
+		}
+
+		auto held = tree.find(1);
+		tree.compact();
+
+		REQUIRE(*held == 1);
+		REQUIRE(tree.size() == static_cast<size_t>(threadsAmount * numberOfElements - (threadsAmount * numberOfElements + 2) / 3));
+
+		for (int i = 0; i < threadsAmount * numberOfElements; ++i) {
+			if (i % 3 != 0) {
+				REQUIRE(*tree.find(i) == i);
+			}
+		}
+
+		int count = 0;
+		auto it = tree.begin();
+		auto last = tree.end();
+		while (it != last) {
+			++it;
+			++count;
+		}
+		REQUIRE(count == static_cast<int>(tree.size()));
+
+		tree.insert({ -1, -1 });
+		tree.erase(2);
+		REQUIRE(*tree.find(-1) == -1);
+		REQUIRE(bool(tree.find(2) == tree.end()));
+
+		AVLTree<int, int> churned;
+		int churnedElements = 10000;
+		for (int i = 0; i < churnedElements; ++i) {
+			churned.insert({ i, i });
+		}
+		churned.compact();
+		auto pinned = churned.find(churnedElements - 1);
+		for (int i = 0; i < churnedElements - 100; ++i) {
+			churned.erase(i);
+		}
+		REQUIRE(*pinned == churnedElements - 1);
+		REQUIRE(churned.size() == 100);
+		count = 0;
+		for (auto cit = churned.begin(); cit != churned.end(); ++cit) {
+			REQUIRE(*cit == churnedElements - 100 + count);
+			++count;
+		}
+		REQUIRE(count == 100);
+	}
+	SECTION("FIND_MANY TEST") {
+		AVLTree<int, int> tree;
+		int numberOfElements = 1000;
+
+		for (int i = 0; i < numberOfElements; ++i) {
+			tree.insert({ i * 10, i });
+		}
+
+		std::vector<int> keys;
+		for (int i = 0; i < numberOfElements; ++i) {
+			keys.push_back(i);
+			keys.push_back(numberOfElements - i - 1);
+		}
+
+		auto values = tree.find_many(keys);
+		REQUIRE(values.size() == keys.size());
+		for (size_t i = 0; i < keys.size(); ++i) {
+			REQUIRE(values[i].has_value() == (keys[i] < numberOfElements));
+			if (values[i]) {
+				REQUIRE(*values[i] == keys[i] * 10);
+			}
+		}
+		REQUIRE(tree.find_many({}).empty());
+	}
+
+	SECTION("FIND_MANY SPEED TEST") {
+		std::cout << "FIND_MANY SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / FIND TIME / FIND_MANY TIME" << std::endl;
+
+		for (int numberOfElements = 10000; numberOfElements <= 1000000; numberOfElements *= 10) {
+			AVLTree<int, int> tree;
+			for (int i = 0; i < numberOfElements; ++i) {
+				tree.insert({ i, i });
+			}
+
+			std::vector<int> keys;
+			for (int i = 0; i < numberOfElements; ++i) {
+				keys.push_back(rand() % numberOfElements);
+			}
+
+			long long sum = 0;
+			auto startFind = std::chrono::high_resolution_clock::now();
+			for (auto key : keys) {
+				sum += *tree.find(key);
+			}
+			auto endFind = std::chrono::high_resolution_clock::now();
+
+			auto startMany = std::chrono::high_resolution_clock::now();
+			auto values = tree.find_many(keys);
+			auto endMany = std::chrono::high_resolution_clock::now();
+
+			long long sumMany = 0;
+			for (auto& value : values) {
+				sumMany += *value;
+			}
+			REQUIRE(sum == sumMany);
+
+			auto timeFind = std::chrono::duration_cast<std::chrono::milliseconds>(endFind - startFind);
+			auto timeMany = std::chrono::duration_cast<std::chrono::milliseconds>(endMany - startMany);
+			std::cout << numberOfElements << "        " << static_cast<double>(timeFind.count()) / 1000.0 << "        " << static_cast<double>(timeMany.count()) / 1000.0 << std::endl;
+		}
+	}
+	SECTION("CONTAINS/GET TEST") {
+		AVLTree<int, int> tree;
+		int threadsAmount = 4;
+		int numberOfElements = 100;
+
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				for (int j = 0; j < numberOfElements; ++j) {
+					tree.insert({ (j + th * numberOfElements) * 2, j + th * numberOfElements });
+				}
+				}, i));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		for (int i = 0; i < threadsAmount * numberOfElements; ++i) {
+			REQUIRE(tree.contains(i));
+			REQUIRE(tree.get(i) == i * 2);
+		}
+
+		tree.erase(5);
+		REQUIRE_FALSE(tree.contains(5));
+		REQUIRE_FALSE(tree.get(5).has_value());
+		REQUIRE_FALSE(tree.contains(threadsAmount * numberOfElements));
+		REQUIRE_FALSE(tree.get(-1).has_value());
+	}
+	SECTION("MIN/MAX/POP TEST") {
+		AVLTree<int, int> tree;
+		int numberOfElements = 200;
+
+		REQUIRE(bool(tree.begin() == tree.end()));
+		REQUIRE_FALSE(tree.pop_min().has_value());
+		REQUIRE_FALSE(tree.pop_max().has_value());
+
+		for (int i = 0; i < numberOfElements; ++i) {
+			int key = (i * 37) % numberOfElements;
+			tree.insert({ key * 2, key });
+		}
+
+		REQUIRE(*tree.min() == 0);
+		REQUIRE(*tree.max() == (numberOfElements - 1) * 2);
+
+		tree.erase(0);
+		tree.erase(numberOfElements - 1);
+		REQUIRE(*tree.begin() == 2);
+		REQUIRE(*tree.max() == (numberOfElements - 2) * 2);
+
+		for (int i = 1; i < numberOfElements / 2; ++i) {
+			auto min = tree.pop_min();
+			REQUIRE(min.has_value());
+			REQUIRE(min->second == i);
+			REQUIRE(min->first == i * 2);
+			auto max = tree.pop_max();
+			REQUIRE(max.has_value());
+			REQUIRE(max->second == numberOfElements - 1 - i);
+		}
+
+		REQUIRE(tree.empty());
+		REQUIRE(bool(tree.begin() == tree.end()));
+		REQUIRE(bool(tree.max() == tree.end()));
+
+		tree.insert({ 10, 5 });
+		REQUIRE(*tree.min() == 10);
+		REQUIRE(*tree.max() == 10);
+	}
+
+	SECTION("POP_MIN SPEED TEST") {
+		std::cout << "POP_MIN SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / POP_MIN TIME" << std::endl;
+		int numberOfElements = 100000;
+
+		for (int threadsAmount = 1; threadsAmount <= 8; threadsAmount *= 2) {
+			AVLTree<int, int> tree;
+			for (int i = 0; i < numberOfElements; ++i) {
+				tree.insert({ i, i });
+			}
+
+			std::vector<std::thread> threads;
+			auto startThreaded = std::chrono::high_resolution_clock::now();
+
+			for (int i = 0; i < threadsAmount; ++i) {
+				threads.push_back(std::thread([&]() {
+					while (tree.pop_min()) {}
+					}));
+			}
+
+			for (int k = 0; k < threadsAmount; ++k) {
+				threads[k].join();
+			}
+
+			auto endThreaded = std::chrono::high_resolution_clock::now();
+			REQUIRE(tree.empty());
+			std::cout << threadsAmount << "        "
+				<< static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(endThreaded - startThreaded).count()) / 1000.0 << std::endl;
+		}
+	}
 }
\ No newline at end of file
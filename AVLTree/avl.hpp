@@ -14,15 +14,47 @@
 #include <vector>
 #include <atomic>
 #include <shared_mutex>
+#include <unordered_map>
+#include <optional>
+#if defined(_M_IX86) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
 
 namespace fefu {
 
+	inline void prefetch(const void* address) {
+#if defined(_M_IX86) || defined(_M_X64)
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+		__builtin_prefetch(address);
+#endif
+	}
+
 	enum class status {
 		DELETED = 0,
 		ACTIVE = 1,
 		END = 2
 	};
 
+	template <typename T, typename K>
+	class node;
+
+	template <typename T, typename K>
+	class node_arena {
+	public:
+		node<T, K>* nodes;
+		std::size_t capacity;
+		std::size_t live = 0;
+
+		node_arena(std::size_t capacity) : capacity(capacity) {
+			nodes = std::allocator<node<T, K>>().allocate(capacity);
+		}
+
+		~node_arena() {
+			std::allocator<node<T, K>>().deallocate(nodes, capacity);
+		}
+	};
+
 	template <typename T, typename K>
 	class node {
 	public:
@@ -32,6 +64,7 @@ namespace fefu {
 		T value;
 		K key;
 		node *left, *right, *parent;
+		node_arena<T, K>* arena = nullptr;
 
 		node(status state) : node_status(state), value(), key() {
 			left = nullptr;
@@ -59,33 +92,54 @@ namespace fefu {
 		}
 
 		void increase_ref() {
-			if (this) {
-				++ref_count;
-			}
+			++ref_count;
 		}
 
 		void decrease_ref() {
-			if (this && ref_count != 0) {
+			if (ref_count != 0) {
 				--ref_count;
 			}
 		}
 
+		static void increase_ref(node* unit) {
+			if (unit) {
+				unit->increase_ref();
+			}
+		}
+
+		static void decrease_ref(node* unit) {
+			if (unit) {
+				unit->decrease_ref();
+			}
+		}
+
+		static void destroy(node* unit) {
+			if (unit->arena) {
+				node_arena<T, K>* arena = unit->arena;
+				unit->~node();
+				if (--arena->live == 0) {
+					delete arena;
+				}
+			}
+			else {
+				delete unit;
+			}
+		}
+
 		void remove() {
-			if (this) {
-				std::vector<node*> stack;
-				stack.push_back(this);
-				while (!stack.empty()) {
-					node* unit = stack[stack.size() - 1];
-					stack.pop_back();
-					if (unit && unit->node_status == status::DELETED && !unit->is_ref()) {
-						unit->left->decrease_ref();
-						unit->right->decrease_ref();
-						unit->parent->decrease_ref();
-						stack.push_back(unit->left);
-						stack.push_back(unit->right);
-						stack.push_back(unit->parent);
-						delete unit;
-					}
+			std::vector<node*> stack;
+			stack.push_back(this);
+			while (!stack.empty()) {
+				node* unit = stack[stack.size() - 1];
+				stack.pop_back();
+				if (unit && unit->node_status == status::DELETED && !unit->is_ref()) {
+					decrease_ref(unit->left);
+					decrease_ref(unit->right);
+					decrease_ref(unit->parent);
+					stack.push_back(unit->left);
+					stack.push_back(unit->right);
+					stack.push_back(unit->parent);
+					destroy(unit);
 				}
 			}
 		}
@@ -130,8 +184,10 @@ namespace fefu {
 
 		AVLIterator& operator=(AVLIterator&& other) {
 			std::unique_lock<std::shared_mutex> lock(*other.mutex);
-			value->decrease_ref();
-			value->remove();
+			if (value) {
+				value->decrease_ref();
+				value->remove();
+			}
 			value = other.value;
 			value->increase_ref();
 			return *this;
@@ -232,6 +288,9 @@ namespace fefu {
 
 		AVLTree() {
 			root = new value_type(status::END);
+			end_node = root;
+			leftmost = root;
+			rightmost = root;
 		}
 
 		~AVLTree() {
@@ -243,12 +302,12 @@ namespace fefu {
 				++current;
 			}
 			while (!stack.empty()) {
-				delete stack[stack.size() - 1];
+				value_type::destroy(stack[stack.size() - 1]);
 				stack.pop_back();	
 			}
-			delete current.value;
+			value_type::destroy(current.value);
 			current.value = nullptr;
-			end.value == nullptr;
+			end.value = nullptr;
 		}
 
 		bool empty() {
@@ -263,20 +322,41 @@ namespace fefu {
 
 		iterator begin() {
 			std::shared_lock<std::shared_mutex> lock(mutex);
-			value_type* current = root;
-			while (current->left) {
-				current = current->left;
-			}
-			return iterator(current, &mutex);
+			return iterator(leftmost, &mutex);
 		}
 
 		iterator end() {
 			std::shared_lock<std::shared_mutex> lock(mutex);
-			value_type* current = root;
-			while (current->right) {
-				current = current->right;
+			return iterator(end_node, &mutex);
+		}
+
+		iterator min() {
+			return begin();
+		}
+
+		iterator max() {
+			std::shared_lock<std::shared_mutex> lock(mutex);
+			return iterator(rightmost, &mutex);
+		}
+
+		std::optional<std::pair<map_type, key_type>> pop_min() {
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			if (empty_inner()) {
+				return std::nullopt;
+			}
+			auto result = std::make_pair(leftmost->value, leftmost->key);
+			erase_unit(leftmost);
+			return result;
+		}
+
+		std::optional<std::pair<map_type, key_type>> pop_max() {
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			if (empty_inner()) {
+				return std::nullopt;
 			}
-			return iterator(current, &mutex);
+			auto result = std::make_pair(rightmost->value, rightmost->key);
+			erase_unit(rightmost);
+			return result;
 		}
 
 		void insert(map_type value, key_type key) {
@@ -296,13 +376,74 @@ namespace fefu {
 
 		iterator find(key_type key) {
 			std::shared_lock<std::shared_mutex> lock(mutex);
-			auto it = iterator(find_node(key), &mutex);
-			if (it.value->key != key) {
-				lock.unlock();
-				return end();
+			value_type* unit = find_node(key);
+			if (unit->key != key) {
+				unit = end_node;
+			}
+			return iterator(unit, &mutex);
+		}
+
+		bool contains(key_type key) {
+			std::shared_lock<std::shared_mutex> lock(mutex);
+			value_type* unit = find_node(key);
+			return unit->key == key && unit->node_status == status::ACTIVE;
+		}
+
+		std::optional<map_type> get(key_type key) {
+			std::shared_lock<std::shared_mutex> lock(mutex);
+			value_type* unit = find_node(key);
+			if (unit->key == key && unit->node_status == status::ACTIVE) {
+				return unit->value;
+			}
+			return std::nullopt;
+		}
+
+		// Looks up all keys under one shared lock. Up to find_group descents are
+		// kept in flight and advanced round-robin, prefetching the next node of
+		// each, so the cache misses of different keys overlap.
+		std::vector<std::optional<map_type>> find_many(const std::vector<key_type>& keys) {
+			std::vector<std::optional<map_type>> result(keys.size());
+			std::shared_lock<std::shared_mutex> lock(mutex);
+
+			value_type* cursor[find_group];
+			size_type slot[find_group];
+			size_type next = 0;
+			size_type active = 0;
+			while (active < find_group && next < keys.size()) {
+				cursor[active] = root;
+				slot[active++] = next++;
+			}
+
+			while (active != 0) {
+				for (size_type i = 0; i < active;) {
+					value_type* current = cursor[i];
+					const key_type& key = keys[slot[i]];
+					value_type* child = nullptr;
+					if (current->key != key) {
+						child = (key < current->key) ? current->left : current->right;
+					}
+
+					if (child) {
+						prefetch(child);
+						cursor[i++] = child;
+						continue;
+					}
+
+					if (current->key == key && current->node_status == status::ACTIVE) {
+						result[slot[i]] = current->value;
+					}
+					if (next < keys.size()) {
+						cursor[i] = root;
+						slot[i++] = next++;
+					}
+					else {
+						--active;
+						cursor[i] = cursor[active];
+						slot[i] = slot[active];
+					}
+				}
 			}
-			lock.unlock();
-			return it;
+			return result;
 		}
 
 		void erase(key_type key) {
@@ -310,11 +451,88 @@ namespace fefu {
 			erase_inner(key);
 		}
 
+		// Moves every node that no iterator pins into one contiguous block laid
+		// out in depth-first order, so lookups after heavy churn touch memory
+		// the way a freshly built tree does. Pinned nodes stay where they are.
+		// A block is only freed once its last node is gone, so erase runs this
+		// again by itself once the erased block nodes outnumber the live ones;
+		// a freed block goes back to the allocator, which need not return it
+		// to the OS.
+		void compact() {
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			compact_inner();
+		}
+
 	private:
+		static constexpr size_type find_group = 8;
+		static constexpr size_type min_recompact = 64;
+
 		value_type *root = nullptr;
+		value_type *end_node = nullptr;
+		value_type *leftmost = nullptr;
+		value_type *rightmost = nullptr;
 		size_type set_size = 0;
+		size_type arena_waste = 0;
 		std::shared_mutex mutex;
 
+		void compact_inner() {
+			arena_waste = 0;
+			std::vector<value_type*> order;
+			std::vector<value_type*> stack;
+			stack.push_back(root);
+			while (!stack.empty()) {
+				value_type* unit = stack[stack.size() - 1];
+				stack.pop_back();
+				order.push_back(unit);
+				if (unit->right) {
+					stack.push_back(unit->right);
+				}
+				if (unit->left) {
+					stack.push_back(unit->left);
+				}
+			}
+
+			size_type movable = 0;
+			for (auto* unit : order) {
+				movable += unit->is_ref() ? 0 : 1;
+			}
+			if (movable == 0) {
+				return;
+			}
+
+			auto* arena = new node_arena<map_type, key_type>(movable);
+			std::unordered_map<value_type*, value_type*> moved;
+			moved.reserve(movable);
+			for (auto* unit : order) {
+				if (!unit->is_ref()) {
+					value_type* copy = new (arena->nodes + arena->live) value_type(std::move(*unit));
+					copy->arena = arena;
+					++arena->live;
+					moved[unit] = copy;
+				}
+			}
+
+			auto relocated = [&moved](value_type* unit) {
+				auto it = moved.find(unit);
+				return it == moved.end() ? unit : it->second;
+			};
+
+			for (auto* unit : order) {
+				value_type* current = relocated(unit);
+				current->left = relocated(current->left);
+				current->right = relocated(current->right);
+				current->parent = relocated(current->parent);
+			}
+			root = relocated(root);
+			end_node = relocated(end_node);
+			leftmost = relocated(leftmost);
+			rightmost = relocated(rightmost);
+
+			for (auto& unit : moved) {
+				value_type::destroy(unit.first);
+			}
+		}
+
 		bool empty_inner() {
 			return set_size == 0;
 		}
@@ -327,6 +545,12 @@ namespace fefu {
 			value_type* parent_node = find_node(key);
 			if (parent_node->key != key || parent_node->node_status == status::END) {
 				value_type* new_node = new value_type(value, key, parent_node);
+				if (leftmost == end_node || key < leftmost->key) {
+					leftmost = new_node;
+				}
+				if (rightmost == end_node || rightmost->key < key) {
+					rightmost = new_node;
+				}
 				if (new_node->key < parent_node->key) {
 					parent_node->left = new_node;
 				}
@@ -346,54 +570,72 @@ namespace fefu {
 			if (!empty_inner()) {
 				value_type* unit = find_node(key);
 				if (unit->key == key && unit->node_status == status::ACTIVE) {
-					--set_size;
-					value_type* lower_unit = unit;
-
-					if (unit->left) {
-						lower_unit = get_lower_right_child(unit->left);
-					}
-					else if (unit->right) {
-						lower_unit = get_lower_left_child(unit->right);
-					}
+					erase_unit(unit);
+				}
+			}
+		}
 
-					root = (unit == root) ? lower_unit : root;
+		void erase_unit(value_type* unit) {
+			if (unit == leftmost) {
+				leftmost = next_node(unit);
+			}
+			if (unit == rightmost) {
+				value_type* prev = prev_node(unit);
+				rightmost = prev ? prev : end_node;
+			}
 
-					if (lower_unit->parent && lower_unit->parent != unit) {
-						if (lower_unit->left) {
-							change_parent_child(lower_unit, lower_unit->left, lower_unit->parent);
-							lower_unit->left->parent = lower_unit->parent;
-						}
-						else if (lower_unit->right) {
-							change_parent_child(lower_unit, lower_unit->right, lower_unit->parent);
-							lower_unit->right->parent = lower_unit->parent;
-						}
-						else {
-							change_parent_child(lower_unit, nullptr, lower_unit->parent);
-						}
-					}
+			--set_size;
+			value_type* lower_unit = unit;
 
-					auto balanced_unit = (lower_unit->parent == unit) ? lower_unit : lower_unit->parent;
-					replace_node(lower_unit, unit);
+			if (unit->left) {
+				lower_unit = get_lower_right_child(unit->left);
+			}
+			else if (unit->right) {
+				lower_unit = get_lower_left_child(unit->right);
+			}
 
-					while (balanced_unit) {
-						balance_delete(balanced_unit);
-						balanced_unit = balanced_unit->parent;
-					}
+			root = (unit == root) ? lower_unit : root;
 
-					delete_node(unit);
+			if (lower_unit->parent && lower_unit->parent != unit) {
+				if (lower_unit->left) {
+					change_parent_child(lower_unit, lower_unit->left, lower_unit->parent);
+					lower_unit->left->parent = lower_unit->parent;
+				}
+				else if (lower_unit->right) {
+					change_parent_child(lower_unit, lower_unit->right, lower_unit->parent);
+					lower_unit->right->parent = lower_unit->parent;
+				}
+				else {
+					change_parent_child(lower_unit, nullptr, lower_unit->parent);
 				}
 			}
+
+			auto balanced_unit = (lower_unit->parent == unit) ? lower_unit : lower_unit->parent;
+			replace_node(lower_unit, unit);
+
+			while (balanced_unit) {
+				balance_delete(balanced_unit);
+				balanced_unit = balanced_unit->parent;
+			}
+
+			delete_node(unit);
+			if (arena_waste > set_size && arena_waste >= min_recompact) {
+				compact_inner();
+			}
 		}
 
 		void delete_node(value_type *unit) {
+			if (unit->arena) {
+				++arena_waste;
+			}
 			unit->node_status = status::DELETED;
 			if (!unit->is_ref()) {
-				delete unit;
+				value_type::destroy(unit);
 				unit = nullptr;
 			} else {
-				unit->parent->increase_ref();
-				unit->left->increase_ref();
-				unit->right->increase_ref();
+				value_type::increase_ref(unit->parent);
+				value_type::increase_ref(unit->left);
+				value_type::increase_ref(unit->right);
 			}
 		}
 
@@ -502,6 +744,26 @@ namespace fefu {
 			return unit;
 		}
 
+		value_type *next_node(value_type *unit) {
+			if (unit->right) {
+				return get_lower_left_child(unit->right);
+			}
+			while (unit->parent && unit->parent->right == unit) {
+				unit = unit->parent;
+			}
+			return unit->parent;
+		}
+
+		value_type *prev_node(value_type *unit) {
+			if (unit->left) {
+				return get_lower_right_child(unit->left);
+			}
+			while (unit->parent && unit->parent->left == unit) {
+				unit = unit->parent;
+			}
+			return unit->parent;
+		}
+
 		height_type get_height(value_type *unit) {
 			if (unit->left && unit->right) {
 				if (unit->left->height < unit->right->height) {
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace fefu {
+
+	// Counter split over cache-line sized stripes so that threads updating it
+	// concurrently do not fight over one line. Each thread always lands on the
+	// same stripe. sum() adds up the stripes and is exact whenever no update
+	// is in flight. approximate() reads a single value that every stripe
+	// refreshes once it has drifted by publish_step, so it is off by at most
+	// stripe_count * publish_step.
+	class striped_counter {
+	public:
+		void add(std::ptrdiff_t delta) {
+			stripe& own = stripes[stripe_index()];
+			std::ptrdiff_t value = own.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+			std::ptrdiff_t published = own.published.load(std::memory_order_relaxed);
+			std::ptrdiff_t drift = value - published;
+			if ((drift >= publish_step || drift <= -publish_step) &&
+				own.published.compare_exchange_strong(published, value, std::memory_order_relaxed)) {
+				estimate.fetch_add(drift, std::memory_order_relaxed);
+			}
+		}
+
+		std::ptrdiff_t sum() {
+			std::ptrdiff_t total = 0;
+			for (auto& own : stripes) {
+				total += own.value.load();
+			}
+			return total;
+		}
+
+		std::ptrdiff_t approximate() {
+			return estimate.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr std::size_t stripe_count = 16;
+		static constexpr std::ptrdiff_t publish_step = 64;
+
+		struct alignas(64) stripe {
+			std::atomic<std::ptrdiff_t> value = 0;
+			std::atomic<std::ptrdiff_t> published = 0;
+		};
+
+		stripe stripes[stripe_count];
+		alignas(64) std::atomic<std::ptrdiff_t> estimate = 0;
+
+		static std::size_t stripe_index() {
+			static std::atomic<std::size_t> next = 0;
+			thread_local std::size_t index = next++ % stripe_count;
+			return index;
+		}
+	};
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace fefu {
+
+	// Process-wide epoch clock shared by every container that defers frees.
+	// Threads register themselves in one of the last three epochs while they
+	// may hold raw node pointers; the counters are striped over cache lines so
+	// unrelated threads do not write the same line on every enter/exit.
+	class epoch_domain {
+	public:
+		static epoch_domain& instance() {
+			static epoch_domain domain;
+			return domain;
+		}
+
+		std::size_t enter() {
+			stripe& own = stripes[stripe_index()];
+			while (true) {
+				std::size_t current = epoch;
+				++own.active[current % 3];
+				if (epoch == current) {
+					return current;
+				}
+				--own.active[current % 3];
+			}
+		}
+
+		void exit(std::size_t entered) {
+			--stripes[stripe_index()].active[entered % 3];
+		}
+
+		std::size_t current() {
+			return epoch;
+		}
+
+		bool try_advance() {
+			std::size_t current = epoch;
+			for (auto& own : stripes) {
+				if (own.active[(current + 2) % 3] != 0) {
+					return false;
+				}
+			}
+			return epoch.compare_exchange_strong(current, current + 1);
+		}
+
+	private:
+		static constexpr std::size_t stripe_count = 16;
+
+		struct alignas(64) stripe {
+			std::atomic<std::size_t> active[3] = {};
+		};
+
+		std::atomic<std::size_t> epoch = 0;
+		stripe stripes[stripe_count];
+
+		epoch_domain() {}
+
+		static std::size_t stripe_index() {
+			static std::atomic<std::size_t> next = 0;
+			thread_local std::size_t index = next++ % stripe_count;
+			return index;
+		}
+	};
+
+	// Intrusive stack of unlinked nodes waiting for their epoch to pass, for
+	// containers whose readers pin an epoch instead of counting references.
+	// Node needs retire_epoch and retire_next members. collect() frees every
+	// node retired at least two epochs ago unless keep() asks to hold on to
+	// it, in which case the node is stamped with the current epoch again.
+	template <typename Node>
+	class retire_list {
+	public:
+		retire_list(epoch_domain& domain) : domain(domain) {}
+
+		~retire_list() {
+			while (Node* node = retired) {
+				retired = node->retire_next;
+				delete node;
+			}
+		}
+
+		void retire(Node* node) {
+			node->retire_epoch = domain.current();
+			push(node);
+			++pending;
+		}
+
+		bool ready() {
+			return pending >= collect_at;
+		}
+
+		void collect() {
+			collect([](Node*) { return false; });
+		}
+
+		template <typename Keep>
+		void collect(Keep keep) {
+			if (collecting.exchange(true)) {
+				return;
+			}
+
+			for (int i = 0; i < 3 && domain.try_advance(); ++i) {}
+			std::size_t current = domain.current();
+
+			Node* chain = retired.exchange(nullptr);
+			std::size_t done = 0;
+			while (chain) {
+				Node* node = chain;
+				chain = chain->retire_next;
+				if (current >= node->retire_epoch + 2 && keep(node)) {
+					node->retire_epoch = current;
+				}
+				if (current >= node->retire_epoch + 2) {
+					delete node;
+					++done;
+				}
+				else {
+					push(node);
+				}
+			}
+
+			collect_at = (pending -= done) + collect_threshold;
+			collecting = false;
+		}
+
+	private:
+		static constexpr std::size_t collect_threshold = 64;
+
+		epoch_domain& domain;
+		std::atomic<Node*> retired = nullptr;
+		std::atomic<std::size_t> pending = 0;
+		std::atomic<std::size_t> collect_at = collect_threshold;
+		std::atomic<bool> collecting = false;
+
+		void push(Node* node) {
+			do {
+				node->retire_next = retired.load();
+			} while (!retired.compare_exchange_weak(node->retire_next, node));
+		}
+	};
+}
@@ -14,10 +14,34 @@
 #include <vector>
 #include <atomic>
 #include <shared_mutex>
+#include <unordered_map>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "epoch.hpp"
+#include "slab.hpp"
+#include "counter.hpp"
+#include "parallel.hpp"
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 namespace fefu {
 
-	template <typename T> class List;
+	class rw_lock;
+	template <typename T, typename Lock = rw_lock> class List;
+	template <typename T, typename Lock = rw_lock> class Purgatory;
+	template <typename T, typename Lock = rw_lock> class ListCursor;
+	template <typename T, typename Compare> class SortedList;
+
+	inline void cpu_relax() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+		_mm_pause();
+#else
+		std::this_thread::yield();
+#endif
+	}
 
 	class rw_lock {
 	public:
@@ -56,11 +80,161 @@ namespace fefu {
 		}
 
 		void unlock() {
-			if (val == WRITE_BIT) {
-				val = 0;
+			uint32_t expected = WRITE_BIT;
+			if (!val.compare_exchange_strong(expected, 0)) {
+				--val;
+			}
+		}
+
+		bool is_free() {
+			return val == 0;
+		}
+	};
+
+	// Same protocol as rw_lock, but a waiter spins with exponential backoff
+	// for a short while and then sleeps in atomic::wait (a futex on Linux)
+	// instead of yielding in a loop. Unlockers only issue a wakeup when
+	// somebody is actually parked.
+	class parking_rw_lock {
+	public:
+		static constexpr uint32_t WRITE_BIT = (1u << 31);
+		static constexpr uint32_t SPIN_LIMIT = 64;
+
+		std::atomic<uint32_t> val = 0;
+		std::atomic<uint32_t> waiters = 0;
+
+		void rlock() {
+			for (uint32_t spin = 1;; spin = backoff(spin)) {
+				uint32_t old = val;
+				if (!(old & WRITE_BIT)) {
+					if (val.compare_exchange_weak(old, old + 1)) {
+						return;
+					}
+					continue;
+				}
+				if (spin > SPIN_LIMIT) {
+					park(old);
+				}
+			}
+		}
+
+		void wlock() {
+			for (uint32_t spin = 1;; spin = backoff(spin)) {
+				uint32_t old = val;
+				if (!(old & WRITE_BIT)) {
+					if (val.compare_exchange_weak(old, old | WRITE_BIT)) {
+						break;
+					}
+					continue;
+				}
+				if (spin > SPIN_LIMIT) {
+					park(old);
+				}
+			}
+			for (uint32_t spin = 1;; spin = backoff(spin)) {
+				uint32_t old = val;
+				if (old == WRITE_BIT) {
+					return;
+				}
+				if (spin > SPIN_LIMIT) {
+					park(old);
+				}
+			}
+		}
+
+		void unlock() {
+			uint32_t expected = WRITE_BIT;
+			if (!val.compare_exchange_strong(expected, 0)) {
+				val.fetch_sub(1);
+			}
+			if (waiters.load() != 0) {
+				val.notify_all();
+			}
+		}
+
+		bool is_free() {
+			return val == 0;
+		}
+
+	private:
+		static uint32_t backoff(uint32_t spin) {
+			if (spin <= SPIN_LIMIT) {
+				for (uint32_t i = 0; i < spin; ++i) {
+					cpu_relax();
+				}
+			}
+			return spin << 1 > spin ? spin << 1 : spin;
+		}
+
+		void park(uint32_t old) {
+			++waiters;
+			val.wait(old);
+			--waiters;
+		}
+	};
+
+	// Phase-fair ticket lock (Brandenburg and Anderson). Readers and writers
+	// alternate in phases: a reader arriving while a writer is present waits
+	// for at most that one writer, and a writer waits for the readers that
+	// were already inside plus the writers queued ahead of it. Neither side
+	// can be starved by a stream of the other.
+	//
+	// rin/rout count readers in units of READER; the low bits of rin mark a
+	// present writer and its phase. Writers are ordered by win/wout tickets.
+	class phase_fair_rw_lock {
+	public:
+		static constexpr uint32_t READER = 0x100;
+		static constexpr uint32_t WRITER_BITS = 0x3;
+		static constexpr uint32_t PRESENT = 0x2;
+		static constexpr uint32_t PHASE = 0x1;
+
+		std::atomic<uint32_t> rin = 0;
+		std::atomic<uint32_t> rout = 0;
+		std::atomic<uint32_t> win = 0;
+		std::atomic<uint32_t> wout = 0;
+		std::atomic<bool> writer = false;
+
+		void rlock() {
+			uint32_t w = rin.fetch_add(READER) & WRITER_BITS;
+			for (uint32_t spin = 0; w != 0 && w == (rin.load() & WRITER_BITS); ++spin) {
+				relax(spin);
+			}
+		}
+
+		void wlock() {
+			uint32_t ticket = win.fetch_add(1);
+			for (uint32_t spin = 0; ticket != wout.load(); ++spin) {
+				relax(spin);
+			}
+			uint32_t entered = rin.fetch_add(PRESENT | (ticket & PHASE));
+			for (uint32_t spin = 0; entered != rout.load(); ++spin) {
+				relax(spin);
+			}
+			writer.store(true);
+		}
+
+		void unlock() {
+			if (writer.load()) {
+				writer.store(false);
+				rin.fetch_and(~WRITER_BITS);
+				wout.fetch_add(1);
 			}
 			else {
-				--val;
+				rout.fetch_add(READER);
+			}
+		}
+
+		bool is_free() {
+			return !writer && (rin & ~WRITER_BITS) == rout && win == wout;
+		}
+
+	private:
+		static void relax(uint32_t spin) {
+			if (spin < 64) {
+				cpu_relax();
+			}
+			else {
+				std::this_thread::yield();
 			}
 		}
 	};
@@ -72,41 +246,100 @@ namespace fefu {
 		BEGIN = 3
 	};
 
-	template <typename T>
+	template <typename T, typename Lock = rw_lock>
 	class list_node {
 	private:
-		template <typename G>
+		template <typename G, typename L>
 		friend class ListIterator;
 
-		template <typename G>
+		template <typename G, typename L>
 		friend class List;
 
-		template <typename G>
+		template <typename G, typename L>
 		friend class Purgatory;
 
+		template <typename G, typename L>
+		friend class ListCursor;
+
+		template <typename G, typename C>
+		friend class SortedList;
+
 		std::atomic<status> node_status;
 		T value;
-		List<T>* list = nullptr;
-		list_node* left, * right;
+		list_node* left;
+		// Stored with release under the node's write lock like the other
+		// links, so scans can follow it with an acquire load and no lock.
+		std::atomic<list_node*> right;
 		std::atomic<std::size_t> ref_count = 0;
+		std::atomic<std::size_t> retire_epoch = 0;
 		std::atomic<int> purged = 0;
-		rw_lock lock;
+		list_node* purge_next = nullptr;
+		std::atomic<uint32_t> seq = 0;
+		Lock lock;
 
-		list_node(status state, List<T>* list) : node_status(state), value(), list(list) {
+		list_node(status state) : node_status(state), value() {
 			left = nullptr;
 			right = nullptr;
 		}
 
-		list_node(status state, T value, List<T>* list) : list_node(state) {
+		list_node(status state, T value) : list_node(state) {
 			this->value = value;
-			this->list = list;
 		}
 
-		list_node(T value, List<T>* list) : node_status(status::ACTIVE), value(value), list(list) {
+		list_node(T value) : node_status(status::ACTIVE), value(value) {
 			left = nullptr;
 			right = nullptr;
 		}
 
+		static void* operator new(std::size_t) {
+			return slab_pool<list_node>::allocate();
+		}
+
+		static void operator delete(void* pointer) {
+			slab_pool<list_node>::deallocate(pointer);
+		}
+
+		// Trivially copyable values are read as a seqlock: copy the bytes and
+		// retry if a writer was active (odd seq) or finished in between. Readers
+		// never write to the node. Other types still take the read lock.
+		T load() {
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				while (true) {
+					uint32_t before = seq.load(std::memory_order_acquire);
+					if (!(before & 1)) {
+						std::array<unsigned char, sizeof(T)> bytes;
+						std::memcpy(bytes.data(), &value, sizeof(T));
+						std::atomic_thread_fence(std::memory_order_acquire);
+						if (seq.load(std::memory_order_relaxed) == before) {
+							return std::bit_cast<T>(bytes);
+						}
+					}
+					cpu_relax();
+				}
+			}
+			else {
+				lock.rlock();
+				T copy = value;
+				lock.unlock();
+				return copy;
+			}
+		}
+
+		void store(T new_value) {
+			lock.wlock();
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				uint32_t before = seq.load(std::memory_order_relaxed);
+				seq.store(before + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				value = new_value;
+				seq.store(before + 2, std::memory_order_release);
+			}
+			else {
+				value = new_value;
+			}
+			lock.unlock();
+		}
+
 		bool is_ref() {
 			return ref_count != 0;
 		}
@@ -122,67 +355,149 @@ namespace fefu {
 		}
 
 		void release() {
-			list->purge_lock.rlock();
-			auto prev_ref = --ref_count;
-			if (prev_ref == 0) {
-				list->purgatory->push_to_purge(this);
+			Purgatory<T, Lock>& purgatory = Purgatory<T, Lock>::instance();
+			std::size_t epoch = purgatory.domain.enter();
+			if (unref()) {
+				purgatory.push_to_purge(this);
 			}
-			list->purge_lock.unlock();
+			purgatory.domain.exit(epoch);
+			purgatory.maybe_collect();
 		}
-	};
-
-	template <typename T>
-	class purgatory_node {
-	private:
-		template<typename G>
-		friend class Purgatory;
-
-		purgatory_node(list_node<T>* node) : node(node), next(nullptr) {}
 
-		list_node<T>* node;
-		purgatory_node<T>* next;
+		// Drops a reference and tells whether the caller has to queue the node
+		// for reclamation. Must be called inside an epoch.
+		bool unref() {
+			retire_epoch = Purgatory<T, Lock>::instance().domain.current() + 1;
+			return --ref_count == 0 && !purged.exchange(1);
+		}
 	};
 
-	template <typename T>
+	// Reclamation service shared by every List<T>. Every traversal step runs
+	// inside an epoch_domain critical section. A node whose reference count
+	// dropped to zero in epoch e is stamped e + 1 and freed once the epoch
+	// reached the stamp + 2, i.e. e + 3, after every step that could still
+	// have been reading a pointer to it has finished. Collection runs on the
+	// releasing threads once enough nodes are pending or have been unlinked,
+	// on the first release after the epoch has moved on since the last
+	// collection, and whenever a list is destroyed.
+	//
+	// Retired nodes are chained through their own purge_next field. Each thread
+	// gathers up to batch_size of them locally and publishes the chain with a
+	// single CAS; a batch started in an older epoch is published before it
+	// grows, and a thread's batch is published when the thread exits.
+	template <typename T, typename Lock>
 	class Purgatory {
 	private:
-		List<T>* list;
-		std::atomic<purgatory_node<T>*> head = nullptr;
-		std::thread purgeThread;
-		std::atomic<bool> purg_cleared = false;
-
-		template<typename G>
+		using node_type = list_node<T, Lock>;
+
+		static constexpr std::size_t collect_threshold = 64;
+		static constexpr std::size_t batch_size = 16;
+
+		class retire_batch {
+		public:
+			node_type* first = nullptr;
+			node_type* last = nullptr;
+			std::size_t size = 0;
+			std::size_t epoch = 0;
+			std::size_t unlinked = 0;
+
+			~retire_batch() {
+				Purgatory<T, Lock>& purgatory = Purgatory<T, Lock>::instance();
+				purgatory.unlinked += unlinked;
+				purgatory.flush(*this);
+			}
+		};
+
+		epoch_domain& domain;
+		std::atomic<node_type*> head = nullptr;
+		std::atomic<std::size_t> pending = 0;
+		std::atomic<std::size_t> unlinked = 0;
+		std::atomic<std::size_t> collect_at = collect_threshold;
+		std::atomic<bool> collecting = false;
+		std::atomic<std::size_t> collected_epoch = 0;
+		bool draining = false;
+
+		template<typename G, typename L>
 		friend class List;
 
-		template<typename G>
+		template<typename G, typename L>
 		friend class list_node;
 
-		Purgatory(List<T>* list) : list(list) {
-			purgeThread = std::thread(&Purgatory::clear_purgatory, this);
-		}
+		template<typename G, typename L>
+		friend class ListIterator;
+
+		Purgatory() : domain(epoch_domain::instance()) {}
 
 		~Purgatory() {
-			purg_cleared = true;
-			purgeThread.join();
+			collecting = true;
+			draining = true;
+			while (node_type* chain = head.exchange(nullptr)) {
+				while (chain) {
+					node_type* node = chain;
+					chain = chain->purge_next;
+					node->purged = 0;
+					if (!node->is_ref()) {
+						release_node(node);
+					}
+				}
+			}
 		}
 
-		void push_to_purge(list_node<T>* node) {
-			purgatory_node<T>* pnode = new purgatory_node<T>(node);
+		static Purgatory& instance() {
+			static Purgatory purgatory;
+			return purgatory;
+		}
 
-			do {
-				pnode->next = head.load();
-			} while (!head.compare_exchange_strong(pnode->next, pnode, std::memory_order_release,
-				std::memory_order_relaxed));
+		static retire_batch& local_batch() {
+			thread_local retire_batch batch;
+			return batch;
 		}
 
-		void remove_node(purgatory_node<T>* prev, purgatory_node<T>* node) {
-			prev->next = node->next;
-			delete node;
+		void push_to_purge(node_type* node) {
+			if (draining) {
+				push_chain(node, node);
+				return;
+			}
+			retire_batch& batch = local_batch();
+			std::size_t current = domain.current();
+			if (batch.first && batch.epoch != current) {
+				flush(batch);
+			}
+			batch.epoch = current;
+			node->purge_next = batch.first;
+			batch.first = node;
+			batch.last = batch.last ? batch.last : node;
+			if (++batch.size == batch_size) {
+				flush(batch);
+			}
 		}
 
-		void release_node(purgatory_node<T>* node) {
-			list_node<T>* left = node->node->left;
-			list_node<T>* right = node->node->right;
+		void flush(retire_batch& batch) {
+			if (batch.first) {
+				push_chain(batch.first, batch.last);
+				pending += batch.size;
+				batch.first = nullptr;
+				batch.last = nullptr;
+				batch.size = 0;
+			}
+		}
+
+		// Publishes a chain already linked through purge_next with one CAS.
+		void retire_chain(node_type* first, node_type* last, std::size_t count) {
+			push_chain(first, last);
+			pending += count;
+		}
+
+		void push_chain(node_type* first, node_type* last) {
+			do {
+				last->purge_next = head.load();
+			} while (!head.compare_exchange_weak(last->purge_next, first, std::memory_order_release,
+				std::memory_order_relaxed));
+		}
+
+		void release_node(node_type* node) {
+			node_type* left = node->left;
+			node_type* right = node->right;
 
 			if (left) {
 				left->release();
@@ -191,71 +506,84 @@ namespace fefu {
 				right->release();
 			}
 
-			delete node->node;
 			delete node;
 		}
 
-		void clear_purgatory() {
-			do {
-				list->purge_lock.wlock();
-
-				purgatory_node<T>* head1 = this->head;
-				
-				list->purge_lock.unlock();
+		// An erased node keeps references to its old neighbours, so a run of
+		// erased nodes only reaches the queue one node at a time as each
+		// predecessor is freed. Unlinks are therefore counted towards the
+		// threshold too, not only nodes already queued.
+		void note_unlinked(std::size_t count) {
+			retire_batch& batch = local_batch();
+			batch.unlinked += count;
+			if (batch.unlinked >= batch_size) {
+				unlinked += batch.unlinked;
+				batch.unlinked = 0;
+			}
+		}
 
-				if (head1) {
-					purgatory_node<T>* prev_node = head1;
-					for (purgatory_node<T>* next_node = head1; next_node;) {
-						purgatory_node<T>* current_node = next_node;
-						next_node = next_node->next;
+		void maybe_collect() {
+			if (pending + unlinked >= collect_at || (pending != 0 && domain.current() != collected_epoch)) {
+				collect();
+			}
+		}
 
-						if (current_node->node->is_ref() || current_node->node->purged) {
-							remove_node(prev_node, current_node);
-						}
-						else {
-							++current_node->node->purged;
-							prev_node = current_node;
+		// Repeats while a pass freed something, since freeing a node may queue
+		// its neighbours; with no reader holding an epoch back, one call
+		// drains every chain of erased nodes.
+		void collect() {
+			flush(local_batch());
+			if (collecting.exchange(true)) {
+				return;
+			}
+			unlinked = 0;
+
+			for (std::size_t freed = 1; freed != 0;) {
+				for (int i = 0; i < 3 && domain.try_advance(); ++i) {}
+				std::size_t current = domain.current();
+				collected_epoch = current;
+
+				node_type* chain = head.exchange(nullptr);
+				node_type* kept_first = nullptr;
+				node_type* kept_last = nullptr;
+				std::size_t done = 0;
+				freed = 0;
+
+				while (chain) {
+					node_type* node = chain;
+					chain = chain->purge_next;
+
+					if (node->is_ref()) {
+						node->purged = 0;
+						if (node->is_ref() || node->purged.exchange(1)) {
+							++done;
+							continue;
 						}
 					}
-
-					list->purge_lock.wlock();
-					purgatory_node<T>* head2 = this->head;
-
-					if (head1 == head2) {
-						head = nullptr;
+					else if (current >= node->retire_epoch + 2) {
+						release_node(node);
+						++done;
+						++freed;
+						continue;
 					}
 
-					list->purge_lock.unlock();
-
-					prev_node = head2;
-					for (purgatory_node<T>* next_node = head2; next_node != head1;) {
-						purgatory_node<T>* current_node = next_node;
-						next_node = next_node->next;
-
-						if (current_node->node->purged == 1) {
-							remove_node(prev_node, current_node);
-						}
-						else {
-							prev_node = current_node;
-						}
-					}
-
-					prev_node->next = nullptr;
-
-					for (purgatory_node<T>* next_node = head1; next_node;) {
-						purgatory_node<T>* current_node = next_node;
-						next_node = next_node->next;
-						release_node(current_node);
-					}
+					node->purge_next = kept_first;
+					kept_first = node;
+					kept_last = kept_last ? kept_last : node;
 				}
-				if (!purg_cleared) {
-					std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+				if (kept_first) {
+					push_chain(kept_first, kept_last);
 				}
-			} while (!purg_cleared || head.load());
+				pending -= done;
+				flush(local_batch());
+			}
+			collect_at = pending + collect_threshold;
+			collecting = false;
 		}
 	};
 
-	template <typename T>
+	template <typename T, typename Lock = rw_lock>
 	class ListIterator {
 	public:
 		using iterator_category = std::forward_iterator_tag;
@@ -264,9 +592,15 @@ namespace fefu {
 		using reference = value_type&;
 		using pointer = value_type*;
 
-		template <typename G>
+		template <typename G, typename L>
 		friend class List;
 
+		template <typename G, typename L>
+		friend class ListCursor;
+
+		template <typename G, typename C>
+		friend class SortedList;
+
 		ListIterator(const ListIterator& other) noexcept {
 			value = other.value;
 			value->increase_ref();
@@ -278,11 +612,7 @@ namespace fefu {
 		}
 
 		value_type operator*() const {
-			value->lock.rlock();
-			auto ref = value->value;
-			value->lock.unlock();
-
-			return ref;
+			return value->load();
 		}
 
 		ListIterator& operator=(const ListIterator& other) {
@@ -331,16 +661,11 @@ namespace fefu {
 		}
 
 		value_type get() {
-			value->lock.rlock();
-			auto val = this->value->value;
-			value->lock.unlock();
-			return val;
+			return value->load();
 		}
 
 		void set(value_type new_value) {
-			value->lock.wlock();
-			this->value->value = new_value;
-			value->lock.unlock();
+			value->store(new_value);
 		}
 
 		ListIterator& operator++() {
@@ -359,6 +684,11 @@ namespace fefu {
 			return *this;
 		}
 
+		ListIterator& advance(std::size_t n) {
+			list->advance(*this, n);
+			return *this;
+		}
+
 		ListIterator operator--(int) {
 			ListIterator temp = *this;
 			inner_minus();
@@ -374,20 +704,20 @@ namespace fefu {
 		}
 
 	private:
-		list_node<value_type>* value = nullptr;
-		List<T>* list;
+		list_node<value_type, Lock>* value = nullptr;
+		List<T, Lock>* list;
 
 		void inner_plus() {
 			if (value && value->node_status != status::END) {
-				list_node<value_type>* prev_value = nullptr;
+				list_node<value_type, Lock>* prev_value = nullptr;
 				{
-					list->purge_lock.rlock();
+					std::size_t epoch = list->domain.enter();
 
 					prev_value = value;
 					value = value->right;
 					value->increase_ref();
 
-					list->purge_lock.unlock();
+					list->domain.exit(epoch);
 				}
 				prev_value->release();
 			}
@@ -395,81 +725,171 @@ namespace fefu {
 
 		void inner_minus() {
 			if (value && value->node_status != status::BEGIN) {
-				list_node<value_type>* prev_value = nullptr;
+				list_node<value_type, Lock>* prev_value = nullptr;
 				{
-					list->purge_lock.rlock();
+					std::size_t epoch = list->domain.enter();
 
 					prev_value = value;
 					value = value->left;
 					value->increase_ref();
 
-					list->purge_lock.unlock();
+					list->domain.exit(epoch);
 				}
 				prev_value->release();
 			}
 		}
 
-		ListIterator(list_node<value_type>* value, List<T>* list) noexcept {
+		ListIterator(list_node<value_type, Lock>* value, List<T, Lock>* list) noexcept {
 			this->value = value;
 			this->value->increase_ref();
 			this->list = list;
 		}
 	};
 
-	template <typename T>
+	// Forward-only scan that does not count references. The cursor stays
+	// inside an epoch while it walks, so even a node erased under it is not
+	// freed and still leads back into the list. A step is one acquire load of
+	// the atomic right link, with no lock and no store to the node, so
+	// concurrent scans of the same list only share its lines for reading.
+	// A scan running across a sort may see part of each order. Every
+	// repin_every steps it holds its node with a reference for a moment and
+	// enters a fresh epoch, so a long scan does not stall reclamation.
+	template <typename T, typename Lock>
+	class ListCursor {
+	public:
+		using value_type = T;
+
+		template <typename G, typename L>
+		friend class List;
+
+		ListCursor(const ListCursor&) = delete;
+		ListCursor& operator=(const ListCursor&) = delete;
+
+		~ListCursor() {
+			list->domain.exit(epoch);
+		}
+
+		bool done() const {
+			return node == list->last;
+		}
+
+		value_type operator*() const {
+			return node->load();
+		}
+
+		ListCursor& operator++() {
+			if (node != list->last) {
+				node = node->right.load(std::memory_order_acquire);
+				if (++steps == repin_every) {
+					repin();
+				}
+			}
+			return *this;
+		}
+
+		// Iterator at the cursor's node, for erase or insert.
+		ListIterator<T, Lock> position() {
+			return ListIterator<T, Lock>(node, list);
+		}
+
+	private:
+		list_node<value_type, Lock>* node;
+		List<T, Lock>* list;
+		std::size_t epoch;
+		std::size_t steps = 0;
+		std::size_t repin_every;
+
+		ListCursor(List<T, Lock>* list, std::size_t repin_every) : list(list), repin_every(repin_every ? repin_every : 1) {
+			epoch = list->domain.enter();
+			node = list->root->right.load(std::memory_order_acquire);
+		}
+
+		void repin() {
+			steps = 0;
+			node->increase_ref();
+			list->domain.exit(epoch);
+			epoch = list->domain.enter();
+			node->release();
+		}
+	};
+
+	template <typename T, typename Lock>
 	class List {
 	public:
 		using size_type = std::size_t;
 		using list_type = T;
-		using value_type = list_node<list_type>;
+		using lock_type = Lock;
+		using value_type = list_node<list_type, lock_type>;
 		using reference = list_type&;
 		using const_reference = const list_type&;
-		using iterator = ListIterator<list_type>;
+		using iterator = ListIterator<list_type, lock_type>;
+		using cursor = ListCursor<list_type, lock_type>;
 
-		template <typename G>
+		template <typename G, typename L>
 		friend class list_node;
 
-		template <typename G>
+		template <typename G, typename L>
 		friend class Purgatory;
 
-		template <typename G>
+		template <typename G, typename L>
 		friend class ListIterator;
 
+		template <typename G, typename L>
+		friend class ListCursor;
+
+		template <typename G, typename C>
+		friend class SortedList;
+
 		List(std::initializer_list<list_type> list) : List() {
 			for (auto it : list)
 				push_back(it);
 		}
 
-		List() {
-			last = new value_type(status::END, this);
-			root = new value_type(status::BEGIN, this);
-			purgatory = new Purgatory<T>(this);
+		List() : purgatory(Purgatory<T, Lock>::instance()), domain(purgatory.domain) {
+			last = new value_type(status::END);
+			root = new value_type(status::BEGIN);
 
 			last->increase_ref();
 			root->increase_ref();
 
 			last->left = root;
-			root->right = last;
+			root->right.store(last, std::memory_order_release);
 		}
 
+		// Unlinks every node and drops the references the links held, so the
+		// nodes are freed through the shared purgatory like erased ones. The
+		// next node stays referenced by its own right neighbour until the
+		// following step, so the walk needs no epoch.
 		~List() {
-			delete purgatory;
-
+			drop_index();
 			value_type* current = root;
 			while (current != last) {
-				value_type* prev = current;
-				current = current->right;
-				delete prev;
+				value_type* next = current->right;
+				current->right = nullptr;
+				next->left = nullptr;
+				current->release();
+				next->release();
+				current = next;
 			}
-			delete current;
+			purgatory.collect();
 		}
 
 		bool empty() {
-			return list_size == 0;
+			return size() == 0;
 		}
 
+		// Sums every stripe. Exact once concurrent mutators have finished;
+		// while they run, the sum can be briefly off in either direction.
 		size_type size() {
-			return list_size;
+			std::ptrdiff_t total = list_size.sum();
+			return total > 0 ? total : 0;
+		}
+
+		// Reads a single shared value that can lag the real size by a few
+		// hundred elements.
+		size_type approx_size() {
+			std::ptrdiff_t total = list_size.approximate();
+			return total > 0 ? total : 0;
 		}
 
 		iterator begin() {
@@ -489,24 +909,30 @@ namespace fefu {
 			return it;
 		}
 
+		cursor scan(size_type repin_every = 1024) {
+			return cursor(this, repin_every);
+		}
+
 		void push_front(list_type value) {
 			root->lock.wlock();
 			value_type* rightR = root->right;
 			rightR->lock.wlock();
 
-			value_type* new_node = new value_type(value, this);
+			value_type* new_node = new value_type(value);
 			new_node->left = root;
-			new_node->right = rightR;
+			new_node->right.store(rightR, std::memory_order_release);
 			new_node->increase_ref();
 			new_node->increase_ref();
 
 
 			rightR->left = new_node;
-			root->right = new_node;
-			++list_size;
+			root->right.store(new_node, std::memory_order_release);
+			list_size.add(1);
+			mutations.add(1);
 
 			root->lock.unlock();
 			rightR->lock.unlock();
+			wake_consumers(1);
 		}
 
 		void push_back(list_type value) {
@@ -526,16 +952,17 @@ namespace fefu {
 					last->lock.wlock();
 
 					if (left->right == last && last->left == left) {
-						value_type* new_node = new value_type(value, this);
+						value_type* new_node = new value_type(value);
 						new_node->left = left;
-						new_node->right = last;
+						new_node->right.store(last, std::memory_order_release);
 						new_node->increase_ref();
 						new_node->increase_ref();
 
-						left->right = new_node;
+						left->right.store(new_node, std::memory_order_release);
 						last->left = new_node;
 
-						++list_size;
+						list_size.add(1);
+						mutations.add(1);
 
 						retry = false;
 					}
@@ -547,6 +974,103 @@ namespace fefu {
 
 				left->release();
 			}
+			wake_consumers(1);
+		}
+
+		// Builds the chain of new nodes privately and links all of it behind
+		// the last node in one critical section.
+		template <typename InputIt>
+		void append_range(InputIt first, InputIt end) {
+			if (first == end) {
+				return;
+			}
+
+			value_type* head = new value_type(*first);
+			value_type* tail = head;
+			size_type count = 1;
+			for (++first; first != end; ++first, ++count) {
+				value_type* new_node = new value_type(*first);
+				new_node->left = tail;
+				tail->right.store(new_node, std::memory_order_release);
+				new_node->increase_ref();
+				tail->increase_ref();
+				tail = new_node;
+			}
+			link_chain(head, tail, count);
+			wake_consumers(count);
+		}
+
+		// Moves every element of other to the end of this list in O(1) by
+		// relinking the two ends of its chain. Locks are taken list by list in
+		// address order, so two splices in opposite directions cannot deadlock.
+		// other must not be modified concurrently, since its elements are
+		// counted when they move.
+		void splice(List& other) {
+			if (&other == this) {
+				return;
+			}
+
+			std::size_t epoch = domain.enter();
+			while (true) {
+				last->lock.rlock();
+				value_type* left = last->left;
+				last->lock.unlock();
+
+				other.root->lock.rlock();
+				value_type* first = other.root->right;
+				other.root->lock.unlock();
+				if (first == other.last) {
+					break;
+				}
+
+				other.last->lock.rlock();
+				value_type* tail = other.last->left;
+				other.last->lock.unlock();
+
+				std::vector<value_type*> locks;
+				std::vector<value_type*> theirs = { other.root, first, tail, other.last };
+				if (first == tail) {
+					theirs.erase(theirs.begin() + 2);
+				}
+				if (std::less<List*>()(&other, this)) {
+					locks = theirs;
+					locks.insert(locks.end(), { left, last });
+				}
+				else {
+					locks = { left, last };
+					locks.insert(locks.end(), theirs.begin(), theirs.end());
+				}
+				for (value_type* node : locks) {
+					node->lock.wlock();
+				}
+
+				bool valid = left->right == last && last->left == left &&
+					other.root->right == first && other.last->left == tail;
+				if (valid) {
+					left->right.store(first, std::memory_order_release);
+					first->left = left;
+					tail->right.store(last, std::memory_order_release);
+					last->left = tail;
+					other.root->right.store(other.last, std::memory_order_release);
+					other.last->left = other.root;
+
+					std::ptrdiff_t moved = other.list_size.sum();
+					other.list_size.add(-moved);
+					other.mutations.add(1);
+					list_size.add(moved);
+					mutations.add(1);
+				}
+
+				for (value_type* node : locks) {
+					node->lock.unlock();
+				}
+				if (valid) {
+					other.drop_stale_index();
+					wake_consumers(2);
+					break;
+				}
+			}
+			domain.exit(epoch);
 		}
 
 		void insert(iterator& it, list_type value) {
@@ -558,7 +1082,6 @@ namespace fefu {
 				push_front(value);
 			}
 			else {
-
 				left->lock.wlock();
 				if (left->node_status == status::DELETED) {
 					left->lock.unlock();
@@ -568,26 +1091,177 @@ namespace fefu {
 				value_type* right = left->right;
 				right->lock.wlock();
 
-				value_type* new_node = new value_type(value, this);
+				value_type* new_node = new value_type(value);
 				new_node->increase_ref();
 				new_node->increase_ref();
 				new_node->left = left;
-				new_node->right = right;
+				new_node->right.store(right, std::memory_order_release);
 
-				left->right = new_node;
+				left->right.store(new_node, std::memory_order_release);
 				right->left = new_node;
 
-				++list_size;
+				list_size.add(1);
+				mutations.add(1);
 
 				left->lock.unlock();
 				right->lock.unlock();
+				wake_consumers(1);
+			}
+		}
+
+		// Element at position i, or end(). Positions come from checkpoints
+		// taken every index_stride nodes, so a lookup walks at most that far.
+		// Any insert or erase invalidates them, and the next lookup rebuilds
+		// them with a full O(n) walk under the exclusive index lock; a list
+		// that keeps changing gets no benefit over walking from begin().
+		// Erasing drops the checkpoints at once, so they never keep erased
+		// nodes from being freed. Under concurrent mutation the result is
+		// only as exact as the list is stable.
+		iterator at(size_type i) {
+			ensure_index();
+			std::shared_lock<std::shared_mutex> lock(index_mutex);
+			iterator it = from_checkpoint(i);
+			lock.unlock();
+			drop_if_stale();
+			return it;
+		}
+
+		// k + 1 iterators cutting the list into k ranges of equal length,
+		// starting with begin() and ending with end().
+		std::vector<iterator> split_points(size_type k) {
+			ensure_index();
+			std::shared_lock<std::shared_mutex> lock(index_mutex);
+			std::vector<iterator> points;
+			points.reserve(k + 1);
+			for (size_type i = 0; i < k; ++i) {
+				points.push_back(from_checkpoint(indexed_size * i / k));
+			}
+			points.push_back(end());
+			lock.unlock();
+			drop_if_stale();
+			return points;
+		}
+
+		// Calls fn on every value. The list is cut into a few ranges per
+		// thread by range_points, and the ranges are shared out by work
+		// stealing.
+		template <typename Fn>
+		void parallel_for_each(Fn fn, size_type threads = parallel::default_threads()) {
+			std::vector<iterator> points = range_points(threads * ranges_per_thread);
+			parallel::run(points.size() - 1, threads, [&](size_type range) {
+				walk_range(points[range].value, points[range + 1].value, [&](value_type* node) {
+					fn(node->load());
+					return true;
+					});
+				});
+		}
+
+		// First element in list order that satisfies pred, or end(). A worker
+		// gives up on its range as soon as a match turns up in an earlier one.
+		template <typename Pred>
+		iterator parallel_find(Pred pred, size_type threads = parallel::default_threads()) {
+			std::vector<iterator> points = range_points(threads * ranges_per_thread);
+			size_type ranges = points.size() - 1;
+			std::atomic<size_type> found = ranges;
+			std::vector<value_type*> hits(ranges, nullptr);
+
+			parallel::run(ranges, threads, [&](size_type range) {
+				walk_range(points[range].value, points[range + 1].value, [&](value_type* node) {
+					if (found < range) {
+						return false;
+					}
+					if (!pred(node->load())) {
+						return true;
+					}
+					node->increase_ref();
+					hits[range] = node;
+					size_type best = found;
+					while (range < best && !found.compare_exchange_weak(best, range)) {}
+					return false;
+					});
+				});
+
+			iterator result = found < ranges ? iterator(hits[found], this) : end();
+			for (value_type* node : hits) {
+				if (node) {
+					node->release();
+				}
 			}
+			return result;
+		}
+
+		// Stable parallel merge sort that relinks the existing nodes. The
+		// whole list is blocked while it runs: every node is write-locked,
+		// left to right like erase, so no insert, erase or locked traversal
+		// gets in until its node is relinked. The node pointers are collected
+		// into one array and compared through their values: one run per
+		// thread is sorted in parallel, then the runs are merged pairwise
+		// between that array and a second one allocated up front, and the
+		// nodes are relinked in the resulting order. Each node keeps one link
+		// from either side, so no reference counts change.
+		template <typename Compare = std::less<list_type>>
+		void sort(Compare compare = Compare(), size_type threads = parallel::default_threads()) {
+			root->lock.wlock();
+			std::vector<value_type*> nodes;
+			nodes.reserve(size());
+			for (value_type* node = root->right;; node = node->right) {
+				node->lock.wlock();
+				if (node == last) {
+					break;
+				}
+				nodes.push_back(node);
+			}
+
+			size_type count = nodes.size();
+			std::vector<value_type*>* sorted = &nodes;
+			std::vector<value_type*> buffer;
+			if (count > 1) {
+				auto less = [&](const value_type* a, const value_type* b) { return compare(a->value, b->value); };
+				threads = std::max<size_type>(1, std::min(threads, count / min_sort_run));
+				auto bound = [&](size_type i) { return count * i / threads; };
+
+				parallel::run(threads, threads, [&](size_type i) {
+					std::stable_sort(nodes.begin() + bound(i), nodes.begin() + bound(i + 1), less);
+					});
+				if (threads > 1) {
+					buffer.resize(count);
+				}
+				std::vector<value_type*>* target = &buffer;
+				for (size_type width = 1; width < threads; width *= 2) {
+					parallel::run((threads + 2 * width - 1) / (2 * width), threads, [&](size_type pair) {
+						size_type i = pair * 2 * width;
+						auto from = sorted->begin();
+						auto first = from + bound(i);
+						auto middle = from + bound(std::min(i + width, threads));
+						auto stop = from + bound(std::min(i + 2 * width, threads));
+						std::merge(first, middle, middle, stop, target->begin() + bound(i), less);
+						});
+					std::swap(sorted, target);
+				}
+			}
+			mutations.add(1);
+
+			// A node is unlocked as soon as both of its links are final. Its
+			// right neighbour is still locked then, so nothing that could see
+			// the rest of the list half relinked gets through.
+			value_type* left = root;
+			for (value_type* node : *sorted) {
+				left->right.store(node, std::memory_order_release);
+				node->left = left;
+				left->lock.unlock();
+				left = node;
+			}
+			left->right.store(last, std::memory_order_release);
+			last->left = left;
+			left->lock.unlock();
+			last->lock.unlock();
+			drop_stale_index();
 		}
 
 		bool checklocks() {
 			value_type* cur = root;
 			while (cur != last) {
-				if (cur->lock.val != 0) {
+				if (!cur->lock.is_free()) {
 					return false;
 				}
 				cur = cur->right;
@@ -596,6 +1270,7 @@ namespace fefu {
 		}
 
 		iterator find(list_type value) {
+			std::size_t epoch = domain.enter();
 			root->lock.rlock();
 			value_type* current = root;
 			current = current->right;
@@ -606,13 +1281,32 @@ namespace fefu {
 				current->lock.unlock();
 				current = right;
 			}
-			return iterator(current, this);
+			iterator it(current, this);
+			domain.exit(epoch);
+			return it;
+		}
+
+		size_type count(list_type value) {
+			std::size_t epoch = domain.enter();
+			root->lock.rlock();
+			value_type* current = root->right;
+			root->lock.unlock();
+			size_type found = 0;
+			while (current != last) {
+				current->lock.rlock();
+				found += current->value == value;
+				value_type* right = current->right;
+				current->lock.unlock();
+				current = right;
+			}
+			domain.exit(epoch);
+			return found;
 		}
 
 		void erase(iterator it) {
 			value_type* node = it.value;
 
-			if (empty() || node->node_status != status::ACTIVE)
+			if (node->node_status != status::ACTIVE)
 				return;
 
 			value_type* left = nullptr;
@@ -639,18 +1333,23 @@ namespace fefu {
 					left->lock.wlock();
 					node->lock.rlock();
 					right->lock.wlock();
-					if (left->right == node && right->left == node) {
+					// An erased neighbour keeps its links, so pointing at node
+					// is not enough: it must still be in the list itself.
+					if (left->node_status != status::DELETED && right->node_status != status::DELETED &&
+						left->right == node && right->left == node) {
 						node->node_status = status::DELETED;
 						node->decrease_ref();
 						node->decrease_ref();
 
-						left->right = right;
+						left->right.store(right, std::memory_order_release);
 						right->left = left;
 
 						left->increase_ref();
 						right->increase_ref();
 
-						--list_size;
+						list_size.add(-1);
+						mutations.add(1);
+						purgatory.note_unlinked(1);
 						retry = false;
 					}
 
@@ -662,6 +1361,7 @@ namespace fefu {
 				left->release();
 				right->release();
 			}
+			drop_stale_index();
 		}
 
 		void pop_back() {
@@ -673,11 +1373,435 @@ namespace fefu {
 			}
 		}
 
+		// Unlinks every element that satisfies pred in one pass and returns
+		// how many went. The walk holds the locks of two neighbours at a time;
+		// a run of matches is unlinked at once under the locks of the run and
+		// the nodes on either side. pred runs under those locks and must not
+		// touch the list.
+		template <typename Pred>
+		size_type remove_if(Pred pred) {
+			size_type removed = 0;
+			value_type* left = root;
+			left->lock.wlock();
+			value_type* current = left->right;
+			current->lock.wlock();
+
+			while (current != last) {
+				value_type* first = current;
+				size_type count = 0;
+				while (current != last && current->node_status == status::ACTIVE && pred(current->value)) {
+					value_type* next = current->right;
+					next->lock.wlock();
+					current = next;
+					++count;
+				}
+				if (count != 0) {
+					unlink_run(left, first, current, count);
+					removed += count;
+				}
+
+				left->lock.unlock();
+				left = current;
+				if (current != last) {
+					current = current->right;
+					current->lock.wlock();
+				}
+			}
+
+			if (left != last) {
+				left->lock.unlock();
+			}
+			last->lock.unlock();
+			if (removed != 0) {
+				drop_stale_index();
+			}
+			return removed;
+		}
+
+		void clear() {
+			remove_if([](const list_type&) { return true; });
+		}
+
+		void pop_front() {
+			if (!empty()) {
+				root->lock.wlock();
+				auto it = iterator(root->right, this);
+				root->lock.unlock();
+				erase(it);
+			}
+		}
+
+		// Unlinks the first element and hands out its value. Returns false
+		// if there is nothing to take.
+		bool try_pop_front(list_type& value) {
+			return take_front(1, [&](const list_type& taken) { value = taken; }) != 0;
+		}
+
+		// Takes up to n elements from the front under one set of locks.
+		std::vector<list_type> try_pop_front_batch(size_type n) {
+			std::vector<list_type> values;
+			take_front(n, [&](const list_type& taken) { values.push_back(taken); });
+			return values;
+		}
+
+		// Blocking versions: spin briefly, then sleep in atomic::wait until a
+		// producer links something new.
+		list_type wait_pop_front() {
+			list_type value;
+			wait_for([&]() { return try_pop_front(value); });
+			return value;
+		}
+
+		std::vector<list_type> wait_pop_front_batch(size_type n) {
+			std::vector<list_type> values;
+			wait_for([&]() {
+				values = try_pop_front_batch(n);
+				return !values.empty();
+				});
+			return values;
+		}
+
 	private:
+		static constexpr size_type index_stride = 32;
+		static constexpr size_type ranges_per_thread = 4;
+		static constexpr size_type min_sort_run = 4096;
+
 		value_type* root = nullptr;
 		value_type* last = nullptr;
-		Purgatory<T>* purgatory;
-		std::atomic<size_type> list_size = 0;
-		rw_lock purge_lock;
+		Purgatory<T, Lock>& purgatory;
+		epoch_domain& domain;
+		striped_counter list_size;
+		striped_counter mutations;
+
+		std::atomic<uint32_t> signal = 0;
+		std::atomic<uint32_t> waiters = 0;
+
+		std::shared_mutex index_mutex;
+		std::vector<value_type*> checkpoints;
+		std::unordered_map<value_type*, size_type> checkpoint_of;
+		size_type indexed_size = 0;
+		std::ptrdiff_t indexed_version = 0;
+		std::atomic<bool> indexed = false;
+
+		// Links a private chain whose inner links already hold their
+		// references behind the last node.
+		void link_chain(value_type* head, value_type* tail, size_type count) {
+			head->increase_ref();
+			tail->increase_ref();
+
+			value_type* left = nullptr;
+			for (bool retry = true; retry;) {
+				{
+					last->lock.wlock();
+
+					left = last->left;
+					left->increase_ref();
+
+					last->lock.unlock();
+				}
+
+				{
+					left->lock.wlock();
+					last->lock.wlock();
+
+					if (left->right == last && last->left == left) {
+						head->left = left;
+						tail->right.store(last, std::memory_order_release);
+
+						left->right.store(head, std::memory_order_release);
+						last->left = tail;
+
+						list_size.add(count);
+						mutations.add(1);
+
+						retry = false;
+					}
+
+					left->lock.unlock();
+					last->lock.unlock();
+				}
+
+				left->release();
+			}
+		}
+
+		// Write-locks root and then up to n ACTIVE nodes after it, left to
+		// right like erase, so the run cannot change under us.
+		template <typename Consume>
+		size_type take_front(size_type n, Consume consume) {
+			root->lock.wlock();
+			value_type* first = root->right;
+			value_type* right = first;
+			right->lock.wlock();
+
+			size_type count = 0;
+			while (count < n && right->node_status == status::ACTIVE) {
+				consume(right->value);
+				value_type* next = right->right;
+				next->lock.wlock();
+				right = next;
+				++count;
+			}
+
+			if (count != 0) {
+				unlink_run(root, first, right, count);
+			}
+			root->lock.unlock();
+			right->lock.unlock();
+			if (count != 0) {
+				drop_stale_index();
+			}
+			return count;
+		}
+
+		// Unlinks the write-locked run first..right->left from between left
+		// and right. Every unlinked node ends up pointing out at left and
+		// right like an erased one, so left and right gain count references
+		// each and every node loses the two its list links held. The run's
+		// locks are released here, one node at a time once nothing in the
+		// run points at it any more; left and right stay locked. Nodes that
+		// are left without references go to the purgatory as one chain.
+		void unlink_run(value_type* left, value_type* first, value_type* right, size_type count) {
+			left->right.store(right, std::memory_order_release);
+			right->left = left;
+			for (value_type* node = first; node != right; node = node->right) {
+				node->node_status = status::DELETED;
+				node->left = left;
+				left->increase_ref();
+				right->increase_ref();
+			}
+			list_size.add(-static_cast<std::ptrdiff_t>(count));
+			mutations.add(1);
+			purgatory.note_unlinked(count);
+
+			value_type* retired_first = nullptr;
+			value_type* retired_last = nullptr;
+			size_type retired = 0;
+
+			std::size_t epoch = domain.enter();
+			for (value_type* node = first; node != right;) {
+				value_type* next = node->right;
+				node->right.store(right, std::memory_order_release);
+				node->decrease_ref();
+				node->lock.unlock();
+				if (node->unref()) {
+					node->purge_next = retired_first;
+					retired_first = node;
+					retired_last = retired_last ? retired_last : node;
+					++retired;
+				}
+				node = next;
+			}
+			if (retired_first) {
+				purgatory.retire_chain(retired_first, retired_last, retired);
+			}
+			domain.exit(epoch);
+			purgatory.maybe_collect();
+		}
+
+		// Callers that linked count new elements. Sleepers are only woken
+		// when some consumer announced itself in waiters.
+		void wake_consumers(size_type count) {
+			if (waiters != 0) {
+				++signal;
+				if (count == 1) {
+					signal.notify_one();
+				}
+				else {
+					signal.notify_all();
+				}
+			}
+		}
+
+		// A consumer registers in waiters before its last attempt, so a
+		// producer that links after that attempt is bound to see it and bump
+		// signal, and the wait below returns at once.
+		template <typename Pop>
+		void wait_for(Pop pop) {
+			for (int spin = 0; !pop(); ++spin) {
+				if (spin < 64) {
+					cpu_relax();
+					continue;
+				}
+				uint32_t seen = signal;
+				++waiters;
+				if (pop()) {
+					--waiters;
+					return;
+				}
+				signal.wait(seen);
+				--waiters;
+			}
+		}
+
+		// Up to k + 1 iterators cutting the list into ranges for the parallel
+		// scans, starting with begin() and ending with end(). Cuts only have
+		// to be in list order, not at exact positions, so the checkpoints are
+		// used whenever there are any: erase, sort and splice drop them, and
+		// inserts since they were taken only make the ranges uneven. Without
+		// them the cuts are sampled by a walk along the right links that
+		// stops at the last cut, without rebuilding the index.
+		std::vector<iterator> range_points(size_type k) {
+			std::vector<iterator> points;
+			points.reserve(k + 1);
+			points.push_back(begin());
+			{
+				std::shared_lock<std::shared_mutex> lock(index_mutex);
+				if (indexed && !checkpoints.empty()) {
+					for (size_type i = 1; i < k; ++i) {
+						points.push_back(iterator(checkpoints[checkpoints.size() * i / k], this));
+					}
+					points.push_back(end());
+					return points;
+				}
+			}
+
+			size_type stride = std::max<size_type>(1, size() / k);
+			std::size_t epoch = domain.enter();
+			value_type* current = points[0].value;
+			for (size_type position = 1; current != last && points.size() < k; ++position) {
+				current = current->right.load(std::memory_order_acquire);
+				if (position % stride == 0 && current != last) {
+					points.push_back(iterator(current, this));
+				}
+			}
+			domain.exit(epoch);
+			points.push_back(end());
+			return points;
+		}
+
+		// Visits the live nodes from current up to stop inside one epoch, until
+		// visit returns false. Links are followed like ListCursor does. stop
+		// may be erased meanwhile; its right link still leads to where it was,
+		// so the walk ends at the first live node at or after it.
+		template <typename Visit>
+		void walk_range(value_type* current, value_type* stop, Visit visit) {
+			std::size_t epoch = domain.enter();
+			while (true) {
+				while (stop->node_status == status::DELETED) {
+					stop = stop->right.load(std::memory_order_acquire);
+				}
+				if (current == stop || current == last) {
+					break;
+				}
+				if (current->node_status == status::ACTIVE && !visit(current)) {
+					break;
+				}
+				current = current->right.load(std::memory_order_acquire);
+			}
+			domain.exit(epoch);
+		}
+
+		void drop_index() {
+			for (value_type* node : checkpoints) {
+				node->release();
+			}
+			checkpoints.clear();
+			checkpoint_of.clear();
+			indexed = false;
+		}
+
+		// Called by everything that unlinks or reorders nodes, after counting
+		// the mutation, so the checkpoint references go with the first erase
+		// and the checkpoints left in place are always in list order.
+		void drop_stale_index() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (indexed) {
+				std::unique_lock<std::shared_mutex> lock(index_mutex);
+				drop_index();
+			}
+		}
+
+		// Rebuilds the checkpoints if anything was inserted or erased since
+		// they were taken. Each checkpoint holds a reference on its node.
+		void ensure_index() {
+			{
+				std::shared_lock<std::shared_mutex> lock(index_mutex);
+				if (indexed && indexed_version == mutations.sum()) {
+					return;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> lock(index_mutex);
+			std::ptrdiff_t version = mutations.sum();
+			if (indexed && indexed_version == version) {
+				return;
+			}
+			drop_index();
+
+			std::size_t epoch = domain.enter();
+			value_type* current = root->right.load(std::memory_order_acquire);
+			size_type position = 0;
+			while (current != last) {
+				if (position % index_stride == 0) {
+					current->increase_ref();
+					checkpoint_of.emplace(current, checkpoints.size());
+					checkpoints.push_back(current);
+				}
+				current = current->right.load(std::memory_order_acquire);
+				++position;
+			}
+			domain.exit(epoch);
+
+			indexed_size = position;
+			indexed_version = version;
+			indexed = true;
+		}
+
+		// Called by the lookups once they are done with the checkpoints. An
+		// erase that raced with the rebuild may have missed indexed being
+		// set; the fences make sure that either it saw it or this sees its
+		// mutation, so stale checkpoints never outlive both.
+		void drop_if_stale() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::ptrdiff_t version = mutations.sum();
+			{
+				std::shared_lock<std::shared_mutex> lock(index_mutex);
+				if (!indexed || indexed_version == version) {
+					return;
+				}
+			}
+			std::unique_lock<std::shared_mutex> lock(index_mutex);
+			if (indexed && indexed_version != mutations.sum()) {
+				drop_index();
+			}
+		}
+
+		// Must be called with index_mutex held.
+		iterator from_checkpoint(size_type i) {
+			if (checkpoints.empty()) {
+				return end();
+			}
+			size_type slot = std::min(i / index_stride, checkpoints.size() - 1);
+			iterator it(checkpoints[slot], this);
+			for (size_type step = slot * index_stride; step < i && it.value != last; ++step) {
+				++it;
+			}
+			return it;
+		}
+
+		// Walks at most index_stride nodes to the next checkpoint, which knows
+		// its position, and jumps from there.
+		void advance(iterator& it, size_type n) {
+			if (n <= 2 * index_stride) {
+				for (; n > 0 && it.value != last; --n) {
+					++it;
+				}
+				return;
+			}
+
+			ensure_index();
+			std::shared_lock<std::shared_mutex> lock(index_mutex);
+			for (size_type steps = 0; steps < n && it.value != last; ++steps) {
+				auto found = checkpoint_of.find(it.value);
+				if (found != checkpoint_of.end()) {
+					it = from_checkpoint(found->second * index_stride + n - steps);
+					break;
+				}
+				++it;
+			}
+			lock.unlock();
+			drop_if_stale();
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,470 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include "epoch.hpp"
+#include "slab.hpp"
+#include "list.hpp"
+
+namespace fefu {
+
+	template <typename T> class LockFreeList;
+
+	// Harris-Michael list node. The low bit of next marks the node as
+	// logically deleted; a marked next is never changed again, so a marked
+	// node can still be walked through while its successors are unlinked.
+	template <typename T>
+	class lockfree_node {
+	private:
+		template <typename G>
+		friend class LockFreeList;
+
+		template <typename G>
+		friend class LockFreeIterator;
+
+		template <typename G>
+		friend class retire_list;
+
+		static constexpr std::uintptr_t MARK_BIT = 1;
+
+		T value;
+		std::atomic<std::uintptr_t> next = 0;
+		std::atomic<uint32_t> seq = 0;
+		std::size_t retire_epoch = 0;
+		lockfree_node* retire_next = nullptr;
+
+		lockfree_node() : value() {}
+
+		lockfree_node(T value) : value(value) {}
+
+		static void* operator new(std::size_t) {
+			return slab_pool<lockfree_node>::allocate();
+		}
+
+		static void operator delete(void* pointer) {
+			slab_pool<lockfree_node>::deallocate(pointer);
+		}
+
+		static lockfree_node* pointer(std::uintptr_t link) {
+			return reinterpret_cast<lockfree_node*>(link & ~MARK_BIT);
+		}
+
+		static bool is_marked(std::uintptr_t link) {
+			return link & MARK_BIT;
+		}
+
+		static std::uintptr_t link(lockfree_node* node) {
+			return reinterpret_cast<std::uintptr_t>(node);
+		}
+
+		bool is_deleted() {
+			return is_marked(next.load());
+		}
+
+		T load() {
+			while (true) {
+				uint32_t before = seq.load(std::memory_order_acquire);
+				if (!(before & 1)) {
+					std::array<unsigned char, sizeof(T)> bytes;
+					std::memcpy(bytes.data(), &value, sizeof(T));
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (seq.load(std::memory_order_relaxed) == before) {
+						return std::bit_cast<T>(bytes);
+					}
+				}
+				cpu_relax();
+			}
+		}
+
+		void store(T new_value) {
+			uint32_t before = seq.load(std::memory_order_relaxed);
+			while ((before & 1) || !seq.compare_exchange_weak(before, before + 1, std::memory_order_relaxed)) {
+				cpu_relax();
+				before = seq.load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_release);
+			value = new_value;
+			seq.store(before + 2, std::memory_order_release);
+		}
+	};
+
+	// An iterator stays inside an epoch for its whole lifetime, so the node it
+	// points at and everything reachable from it outlives the iterator even
+	// after being unlinked. Long-lived iterators therefore hold back
+	// reclamation for every container sharing the epoch_domain. It also
+	// remembers the node it was reached from, which lets erase unlink
+	// without searching from the root.
+	template <typename T>
+	class LockFreeIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type&;
+		using pointer = value_type*;
+
+		template <typename G>
+		friend class LockFreeList;
+
+		LockFreeIterator(const LockFreeIterator& other) noexcept {
+			value = other.value;
+			previous = other.previous;
+			list = other.list;
+			epoch = list->domain.enter();
+		}
+
+		~LockFreeIterator() {
+			list->domain.exit(epoch);
+		}
+
+		LockFreeIterator& operator=(const LockFreeIterator& other) {
+			std::size_t entered = other.list->domain.enter();
+			list->domain.exit(epoch);
+			epoch = entered;
+			value = other.value;
+			previous = other.previous;
+			list = other.list;
+			return *this;
+		}
+
+		value_type operator*() const {
+			return value->load();
+		}
+
+		value_type get() {
+			return value->load();
+		}
+
+		void set(value_type new_value) {
+			value->store(new_value);
+		}
+
+		LockFreeIterator& operator++() {
+			inner_plus();
+			return *this;
+		}
+
+		LockFreeIterator operator++(int) {
+			LockFreeIterator temp = *this;
+			inner_plus();
+			return temp;
+		}
+
+		bool operator==(const LockFreeIterator& other) {
+			return other.value == this->value;
+		}
+
+		bool operator!=(const LockFreeIterator& other) {
+			return other.value != this->value;
+		}
+
+	private:
+		using node_type = lockfree_node<value_type>;
+
+		node_type* value = nullptr;
+		node_type* previous = nullptr;
+		LockFreeList<T>* list;
+		std::size_t epoch;
+
+		void inner_plus() {
+			if (value) {
+				previous = value;
+				value = list->first_alive(previous);
+			}
+		}
+
+		LockFreeIterator(node_type* value, node_type* previous, LockFreeList<T>* list, std::size_t epoch) noexcept {
+			this->value = value;
+			this->previous = previous;
+			this->list = list;
+			this->epoch = epoch;
+		}
+	};
+
+	// Lock-free singly linked list (Harris, Michael). erase marks the node's
+	// next pointer and then unlinks it with a CAS on the predecessor the
+	// iterator was reached from; only if that predecessor has changed or was
+	// deleted itself does it fall back to a pass from the root, which helps
+	// unlinking every marked node it meets. Unlinked nodes are freed through
+	// the shared epoch_domain once every thread that could still see them has
+	// left its epoch. Values are read through a seqlock, so T must be
+	// trivially copyable.
+	//
+	// Unlike List there is no operator-- (nodes only link forward, so
+	// pop_back walks from the root to the last live node) and no support for
+	// other value types. Every iterator pins the process-wide epoch_domain
+	// for as long as it lives, so holding one stalls reclamation for every
+	// List, LockFreeList and UnrolledList, not only this one.
+	template <typename T>
+	class LockFreeList {
+	public:
+		static_assert(std::is_trivially_copyable_v<T>, "LockFreeList requires a trivially copyable T");
+
+		using size_type = std::size_t;
+		using list_type = T;
+		using value_type = lockfree_node<list_type>;
+		using iterator = LockFreeIterator<list_type>;
+
+		template <typename G>
+		friend class LockFreeIterator;
+
+		LockFreeList(std::initializer_list<list_type> list) : LockFreeList() {
+			for (auto it : list)
+				push_back(it);
+		}
+
+		LockFreeList() : domain(epoch_domain::instance()), retired(domain) {
+			root = new value_type();
+			tail = root;
+		}
+
+		~LockFreeList() {
+			value_type* current = root;
+			while (current) {
+				value_type* next = value_type::pointer(current->next.load());
+				delete current;
+				current = next;
+			}
+		}
+
+		bool empty() {
+			return list_size == 0;
+		}
+
+		size_type size() {
+			return list_size;
+		}
+
+		iterator begin() {
+			std::size_t epoch = domain.enter();
+			value_type* previous = root;
+			value_type* first = first_alive(previous);
+			return iterator(first, previous, this, epoch);
+		}
+
+		iterator end() {
+			return iterator(nullptr, nullptr, this, domain.enter());
+		}
+
+		void push_front(list_type value) {
+			value_type* new_node = new value_type(value);
+			std::uintptr_t first = root->next.load();
+			do {
+				new_node->next.store(first, std::memory_order_relaxed);
+			} while (!root->next.compare_exchange_weak(first, value_type::link(new_node)));
+			++list_size;
+		}
+
+		// Appends after the last node, starting from a tail hint that may lag
+		// behind or point at an unlinked node. A deleted last node is unlinked
+		// through the node the walk came from; only when the hint itself is
+		// that node, or the predecessor was deleted too, does a helping pass
+		// from the root run before retrying. The hint is only stored while
+		// inside an epoch, and collect() moves it back to the root before
+		// freeing the node it points at.
+		void push_back(list_type value) {
+			value_type* new_node = new value_type(value);
+			std::size_t epoch = domain.enter();
+			value_type* previous = nullptr;
+			value_type* current = tail.load();
+			while (true) {
+				std::uintptr_t next = current->next.load();
+				if (next == 0) {
+					if (current->next.compare_exchange_strong(next, value_type::link(new_node))) {
+						break;
+					}
+				}
+				if (next == value_type::MARK_BIT) {
+					if (previous && unlink_after(previous, current)) {
+						current = previous;
+					}
+					else {
+						unlink_marked(nullptr);
+						current = root;
+					}
+					previous = nullptr;
+				}
+				else if (next != 0) {
+					previous = current;
+					current = value_type::pointer(next);
+				}
+			}
+			tail.store(new_node);
+			++list_size;
+			domain.exit(epoch);
+			maybe_collect();
+		}
+
+		void insert(iterator& it, list_type value) {
+			value_type* left = it.value;
+			if (!left) {
+				push_back(value);
+				return;
+			}
+
+			value_type* new_node = new value_type(value);
+			std::uintptr_t next = left->next.load();
+			do {
+				if (value_type::is_marked(next)) {
+					delete new_node;
+					return;
+				}
+				new_node->next.store(next, std::memory_order_relaxed);
+			} while (!left->next.compare_exchange_weak(next, value_type::link(new_node)));
+			++list_size;
+		}
+
+		iterator find(list_type value) {
+			std::size_t epoch = domain.enter();
+			value_type* previous = root;
+			value_type* current = first_alive(previous);
+			while (current && current->load() != value) {
+				previous = current;
+				current = first_alive(previous);
+			}
+			return iterator(current, previous, this, epoch);
+		}
+
+		void erase(iterator it) {
+			value_type* node = it.value;
+			if (!node) {
+				return;
+			}
+
+			std::uintptr_t next = node->next.load();
+			do {
+				if (value_type::is_marked(next)) {
+					return;
+				}
+			} while (!node->next.compare_exchange_weak(next, next | value_type::MARK_BIT));
+			--list_size;
+
+			if (!it.previous || !unlink_after(it.previous, node)) {
+				unlink_marked(node);
+			}
+			maybe_collect();
+		}
+
+		void pop_front() {
+			iterator it = begin();
+			erase(it);
+		}
+
+		// Marks the last live node, which is only the last one while its next
+		// is still null; if a push_back or another pop gets in first, the walk
+		// starts over.
+		void pop_back() {
+			std::size_t epoch = domain.enter();
+			while (true) {
+				value_type* previous = root;
+				value_type* before_last = nullptr;
+				value_type* last = nullptr;
+				for (value_type* current = first_alive(previous); current; current = first_alive(previous)) {
+					before_last = previous;
+					last = current;
+					previous = current;
+				}
+				if (!last) {
+					break;
+				}
+
+				std::uintptr_t expected = 0;
+				if (last->next.compare_exchange_strong(expected, value_type::MARK_BIT)) {
+					--list_size;
+					if (!unlink_after(before_last, last)) {
+						unlink_marked(last);
+					}
+					break;
+				}
+			}
+			domain.exit(epoch);
+			maybe_collect();
+		}
+
+	private:
+		value_type* root = nullptr;
+		std::atomic<value_type*> tail = nullptr;
+		epoch_domain& domain;
+		retire_list<value_type> retired;
+		std::atomic<size_type> list_size = 0;
+
+		// First live node after previous. previous is moved along to the node
+		// whose next pointed at the result, which may be a marked one.
+		value_type* first_alive(value_type*& previous) {
+			value_type* current = value_type::pointer(previous->next.load());
+			while (current && current->is_deleted()) {
+				previous = current;
+				current = value_type::pointer(current->next.load());
+			}
+			return current;
+		}
+
+		// Unlinks the marked node with one CAS on previous. Fails if previous
+		// no longer points at it unmarked: previous was deleted, something was
+		// inserted in between, or another thread unlinked it first.
+		bool unlink_after(value_type* previous, value_type* node) {
+			std::size_t epoch = domain.enter();
+			std::uintptr_t expected = value_type::link(node);
+			std::uintptr_t next = node->next.load() & ~value_type::MARK_BIT;
+			bool unlinked = previous->next.compare_exchange_strong(expected, next);
+			if (unlinked) {
+				value_type* hint = node;
+				tail.compare_exchange_strong(hint, previous);
+				retired.retire(node);
+			}
+			domain.exit(epoch);
+			return unlinked;
+		}
+
+		// Walks from the root and unlinks every marked node it meets. Stops
+		// early once target has been unlinked by this pass.
+		void unlink_marked(value_type* target) {
+			std::size_t epoch = domain.enter();
+			bool retry = true;
+			while (retry) {
+				retry = false;
+				value_type* previous = root;
+				std::uintptr_t current_link = previous->next.load();
+				while (value_type* current = value_type::pointer(current_link)) {
+					std::uintptr_t next = current->next.load();
+					if (value_type::is_marked(next)) {
+						std::uintptr_t expected = value_type::link(current);
+						if (!previous->next.compare_exchange_strong(expected, next & ~value_type::MARK_BIT)) {
+							retry = true;
+							break;
+						}
+						if (tail.load() == current) {
+							tail.compare_exchange_strong(current, previous);
+						}
+						retired.retire(current);
+						if (current == target) {
+							domain.exit(epoch);
+							return;
+						}
+						current_link = next & ~value_type::MARK_BIT;
+						continue;
+					}
+					previous = current;
+					current_link = next;
+				}
+			}
+			domain.exit(epoch);
+		}
+
+		void maybe_collect() {
+			if (retired.ready()) {
+				retired.collect([this](value_type* node) {
+					value_type* hint = node;
+					return tail.compare_exchange_strong(hint, root);
+				});
+			}
+		}
+	};
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fefu {
+
+	// Work-stealing loop over task indices, run on a persistent pool. Every
+	// worker owns a contiguous slice of [0, count) and takes indices from its
+	// front; a worker whose slice ran dry steals from the back of the other
+	// slices. A slice is one packed front/back word, so taking and stealing
+	// are a single CAS each and never hand out the same index twice. The
+	// calling thread works as one of the workers.
+	namespace parallel {
+
+		class slices {
+		public:
+			slices(std::size_t count, std::size_t workers) : parts(new part[workers]), workers(workers) {
+				for (std::size_t i = 0; i < workers; ++i) {
+					parts[i].bounds = pack(count * i / workers, count * (i + 1) / workers);
+				}
+			}
+
+			// Next index for worker, its own first; false once every slice is empty.
+			bool next(std::size_t worker, std::size_t& index) {
+				if (take(parts[worker], false, index)) {
+					return true;
+				}
+				for (std::size_t i = 1; i < workers; ++i) {
+					if (take(parts[(worker + i) % workers], true, index)) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+		private:
+			struct alignas(64) part {
+				std::atomic<uint64_t> bounds = 0;
+			};
+
+			std::unique_ptr<part[]> parts;
+			std::size_t workers;
+
+			static uint64_t pack(std::size_t front, std::size_t back) {
+				return (static_cast<uint64_t>(back) << 32) | static_cast<uint32_t>(front);
+			}
+
+			static bool take(part& from, bool steal, std::size_t& index) {
+				uint64_t bounds = from.bounds;
+				while (true) {
+					std::size_t front = static_cast<uint32_t>(bounds);
+					std::size_t back = static_cast<std::size_t>(bounds >> 32);
+					if (front >= back) {
+						return false;
+					}
+					uint64_t taken = steal ? pack(front, back - 1) : pack(front + 1, back);
+					if (from.bounds.compare_exchange_weak(bounds, taken)) {
+						index = steal ? back - 1 : front;
+						return true;
+					}
+				}
+			}
+		};
+
+		// Worker threads started on first use and kept for the rest of the
+		// process, so a parallel call only wakes them instead of creating and
+		// joining threads, and their thread-local caches stay warm. One job
+		// runs at a time; a call made while the pool is busy, including one
+		// from inside a task, runs on the calling thread alone. The pool grows
+		// to the largest number of threads ever asked for. It is never
+		// destroyed, so the workers never run into statics torn down at exit.
+		class pool {
+		public:
+			static pool& instance() {
+				static pool* shared = new pool();
+				return *shared;
+			}
+
+			// Runs worker(id) on the calling thread as id 0 and on threads - 1
+			// pool workers, and returns once all of them have.
+			template <typename Worker>
+			void run(std::size_t threads, Worker& worker) {
+				if (threads < 2 || busy.exchange(true)) {
+					worker(0);
+					return;
+				}
+
+				while (workers.size() < threads - 1) {
+					workers.push_back(std::thread(&pool::serve, this, workers.size() + 1, generation));
+				}
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					job = &worker;
+					call = [](void* context, std::size_t id) { (*static_cast<Worker*>(context))(id); };
+					helpers = threads - 1;
+					running = threads - 1;
+					++generation;
+				}
+				wake.notify_all();
+
+				worker(0);
+				for (std::size_t left = running; left != 0; left = running) {
+					running.wait(left);
+				}
+				busy = false;
+			}
+
+		private:
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::vector<std::thread> workers;
+			std::size_t generation = 0;
+			std::size_t helpers = 0;
+			void* job = nullptr;
+			void (*call)(void*, std::size_t) = nullptr;
+			std::atomic<std::size_t> running = 0;
+			std::atomic<bool> busy = false;
+
+			pool() {}
+
+			// A worker only takes jobs posted after it started, and only those
+			// that asked for at least id helpers.
+			void serve(std::size_t id, std::size_t seen) {
+				while (true) {
+					std::unique_lock<std::mutex> lock(mutex);
+					wake.wait(lock, [&]() { return generation != seen; });
+					seen = generation;
+					if (id > helpers) {
+						continue;
+					}
+					void* current = job;
+					void (*current_call)(void*, std::size_t) = call;
+					lock.unlock();
+
+					current_call(current, id);
+					if (--running == 0) {
+						running.notify_all();
+					}
+				}
+			}
+		};
+
+		template <typename Task>
+		void run(std::size_t count, std::size_t threads, Task task) {
+			threads = std::max<std::size_t>(1, std::min(threads, count));
+			slices work(count, threads);
+			auto worker = [&](std::size_t id) {
+				std::size_t index;
+				while (work.next(id, index)) {
+					task(index);
+				}
+			};
+			pool::instance().run(threads, worker);
+		}
+
+		inline std::size_t default_threads() {
+			return std::max(1u, std::thread::hardware_concurrency());
+		}
+	}
+}
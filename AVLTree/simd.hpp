@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+namespace fefu {
+
+	// Vectorised linear search over contiguous arrays of arithmetic values.
+	// Each step compares one register's worth of values (32 bytes with AVX2,
+	// 16 with SSE2) and turns the result into a byte mask, so a match's index
+	// is its first set bit divided by sizeof(T). Types and targets without a
+	// vector path fall back to std::find / std::count.
+	namespace simd {
+
+#if defined(__AVX2__)
+		using vector = __m256i;
+		constexpr std::size_t width = 32;
+#define FEFU_SIMD 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		using vector = __m128i;
+		constexpr std::size_t width = 16;
+#define FEFU_SIMD 1
+#endif
+
+#ifdef FEFU_SIMD
+#if defined(__AVX2__) || defined(__SSE4_1__)
+		constexpr bool wide_integers = true;
+#else
+		constexpr bool wide_integers = false;
+#endif
+
+		template <typename T>
+		constexpr bool vectorizable = !std::is_same_v<T, bool> &&
+			((std::is_integral_v<T> && (sizeof(T) != 8 || wide_integers)) ||
+				std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+		template <typename T>
+		uint32_t match_mask(const T* data, T value) {
+#if defined(__AVX2__)
+			vector block = _mm256_loadu_si256(reinterpret_cast<const vector*>(data));
+			if constexpr (std::is_same_v<T, float>) {
+				__m256 equal = _mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_set1_ps(value), _CMP_EQ_OQ);
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_castps_si256(equal)));
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				__m256d equal = _mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_set1_pd(value), _CMP_EQ_OQ);
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_castpd_si256(equal)));
+			}
+			else if constexpr (sizeof(T) == 1) {
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(static_cast<char>(value)))));
+			}
+			else if constexpr (sizeof(T) == 2) {
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, _mm256_set1_epi16(static_cast<short>(value)))));
+			}
+			else if constexpr (sizeof(T) == 4) {
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, _mm256_set1_epi32(static_cast<int>(value)))));
+			}
+			else {
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(block, _mm256_set1_epi64x(static_cast<long long>(value)))));
+			}
+#else
+			vector block = _mm_loadu_si128(reinterpret_cast<const vector*>(data));
+			if constexpr (std::is_same_v<T, float>) {
+				__m128 equal = _mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_set1_ps(value));
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_castps_si128(equal)));
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				__m128d equal = _mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_set1_pd(value));
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_castpd_si128(equal)));
+			}
+			else if constexpr (sizeof(T) == 1) {
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(value)))));
+			}
+			else if constexpr (sizeof(T) == 2) {
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, _mm_set1_epi16(static_cast<short>(value)))));
+			}
+			else if constexpr (sizeof(T) == 4) {
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(block, _mm_set1_epi32(static_cast<int>(value)))));
+			}
+			else {
+#if defined(__SSE4_1__)
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi64(block, _mm_set1_epi64x(static_cast<long long>(value)))));
+#else
+				return 0;
+#endif
+			}
+#endif
+		}
+#else
+		template <typename T>
+		constexpr bool vectorizable = false;
+#endif
+
+		template <typename T>
+		std::size_t find(const T* data, std::size_t size, const T& value) {
+			std::size_t index = 0;
+#ifdef FEFU_SIMD
+			if constexpr (vectorizable<T>) {
+				constexpr std::size_t step = width / sizeof(T);
+				for (; index + step <= size; index += step) {
+					uint32_t mask = match_mask(data + index, value);
+					if (mask) {
+						return index + std::countr_zero(mask) / sizeof(T);
+					}
+				}
+			}
+#endif
+			return std::find(data + index, data + size, value) - data;
+		}
+
+		template <typename T>
+		std::size_t count(const T* data, std::size_t size, const T& value) {
+			std::size_t index = 0;
+			std::size_t found = 0;
+#ifdef FEFU_SIMD
+			if constexpr (vectorizable<T>) {
+				constexpr std::size_t step = width / sizeof(T);
+				for (; index + step <= size; index += step) {
+					found += std::popcount(match_mask(data + index, value)) / sizeof(T);
+				}
+			}
+#endif
+			return found + std::count(data + index, data + size, value);
+		}
+	}
+}
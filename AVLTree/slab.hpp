@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace fefu {
+
+	// Per-thread slab allocator for fixed-size nodes. Every thread carves slots
+	// out of its own slabs and reuses them through a private free list. A slot
+	// freed by another thread is queued in that thread's batch and handed back
+	// to the owning cache in one CAS, where the owner picks the whole stack up
+	// the next time its free list runs dry. A cache outlives its thread until
+	// the last of its slots has come back.
+	template <typename T>
+	class slab_pool {
+	public:
+		static void* allocate() {
+			return caches().own->pop();
+		}
+
+		static void deallocate(void* pointer) {
+			slot* unit = reinterpret_cast<slot*>(pointer);
+			if (exited()) {
+				push_remote(unit->owner, unit, unit, 1);
+				return;
+			}
+
+			thread_caches& local = caches();
+			if (unit->owner == local.own) {
+				local.own->push(unit);
+				return;
+			}
+
+			if (local.target != unit->owner) {
+				local.flush_remote();
+				local.target = unit->owner;
+			}
+			unit->next = local.first;
+			local.first = unit;
+			local.last = local.last ? local.last : unit;
+			if (++local.size == remote_batch) {
+				local.flush_remote();
+			}
+		}
+
+	private:
+		static constexpr std::size_t slab_size = 256;
+		static constexpr std::size_t remote_batch = 32;
+
+		class slab_cache;
+
+		struct slot {
+			alignas(T) unsigned char storage[sizeof(T)];
+			slab_cache* owner;
+			slot* next;
+		};
+
+		class slab_cache {
+		public:
+			slot* free_list = nullptr;
+			std::atomic<slot*> remote = nullptr;
+			std::atomic<std::size_t> live = 1;
+			std::vector<slot*> slabs;
+
+			~slab_cache() {
+				for (slot* slab : slabs) {
+					::operator delete(slab);
+				}
+			}
+
+			slot* pop() {
+				if (!free_list) {
+					free_list = remote.exchange(nullptr, std::memory_order_acquire);
+				}
+				if (!free_list) {
+					grow();
+				}
+				slot* unit = free_list;
+				free_list = unit->next;
+				++live;
+				return unit;
+			}
+
+			void push(slot* unit) {
+				unit->next = free_list;
+				free_list = unit;
+				--live;
+			}
+
+			void grow() {
+				slot* slab = static_cast<slot*>(::operator new(sizeof(slot) * slab_size));
+				slabs.push_back(slab);
+				for (std::size_t i = 0; i < slab_size; ++i) {
+					slab[i].owner = this;
+					slab[i].next = free_list;
+					free_list = &slab[i];
+				}
+			}
+
+			void release(std::size_t count) {
+				if (live.fetch_sub(count) == count) {
+					delete this;
+				}
+			}
+		};
+
+		class thread_caches {
+		public:
+			slab_cache* own = new slab_cache();
+			slab_cache* target = nullptr;
+			slot* first = nullptr;
+			slot* last = nullptr;
+			std::size_t size = 0;
+
+			~thread_caches() {
+				flush_remote();
+				exited() = true;
+				own->release(1);
+			}
+
+			void flush_remote() {
+				if (first) {
+					push_remote(target, first, last, size);
+					first = nullptr;
+					last = nullptr;
+					size = 0;
+				}
+			}
+		};
+
+		static thread_caches& caches() {
+			thread_local thread_caches local;
+			return local;
+		}
+
+		static bool& exited() {
+			thread_local bool flag = false;
+			return flag;
+		}
+
+		static void push_remote(slab_cache* owner, slot* first, slot* last, std::size_t count) {
+			do {
+				last->next = owner->remote.load();
+			} while (!owner->remote.compare_exchange_weak(last->next, first, std::memory_order_release,
+				std::memory_order_relaxed));
+			owner->release(count);
+		}
+	};
+}
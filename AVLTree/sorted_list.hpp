@@ -0,0 +1,361 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <random>
+#include <thread>
+#include <vector>
+#include "list.hpp"
+
+namespace fefu {
+
+	// List kept in ascending order under Compare, with a skip-list index over
+	// a random quarter of its nodes. The index only narrows the search: a
+	// lookup descends the towers without locks inside an epoch to the closest
+	// indexed node before the key and then walks the list itself, and the
+	// answer is validated against the list links under the node locks,
+	// retrying if a concurrent insert or erase got in between. The towers
+	// form a lazy skip list: each tower has its own lock, a tower is linked
+	// or unlinked under the locks of its predecessors after checking they
+	// still point where the search left them, and unlinked towers are freed
+	// once the epoch has moved past every reader. Iteration is plain List
+	// iteration. Values must not be changed through set() in a way that
+	// breaks the order.
+	template <typename T, typename Compare = std::less<T>>
+	class SortedList {
+	public:
+		using size_type = std::size_t;
+		using list_type = T;
+		using value_type = list_node<list_type>;
+		using iterator = ListIterator<list_type>;
+
+		SortedList(std::initializer_list<list_type> list) : SortedList() {
+			for (auto it : list)
+				insert(it);
+		}
+
+		SortedList(Compare compare = Compare()) : compare(compare) {}
+
+		~SortedList() {
+			tower* current = head.next[0];
+			while (current) {
+				tower* next = current->next[0].load();
+				current->node->release();
+				delete current;
+				current = next;
+			}
+		}
+
+		bool empty() {
+			return list.empty();
+		}
+
+		size_type size() {
+			return list.size();
+		}
+
+		iterator begin() {
+			return list.begin();
+		}
+
+		iterator end() {
+			return list.end();
+		}
+
+		// First element not less than value.
+		iterator lower_bound(list_type value) {
+			return search(value, false);
+		}
+
+		// First element greater than value.
+		iterator upper_bound(list_type value) {
+			return search(value, true);
+		}
+
+		iterator find(list_type value) {
+			iterator it = lower_bound(value);
+			if (it.value != list.last && !compare(value, it.value->load())) {
+				return it;
+			}
+			return end();
+		}
+
+		bool contains(list_type value) {
+			return find(value) != end();
+		}
+
+		// Links the value after every element not greater than it, so equal
+		// values keep their insertion order.
+		iterator insert(list_type value) {
+			while (true) {
+				std::size_t epoch = list.domain.enter();
+				value_type* left = predecessor(value, true);
+
+				left->lock.wlock();
+				value_type* right = left->right;
+				right->lock.wlock();
+
+				if (left->node_status != status::DELETED &&
+					(right == list.last || compare(value, right->value))) {
+					value_type* new_node = new value_type(value);
+					new_node->increase_ref();
+					new_node->increase_ref();
+					new_node->left = left;
+					new_node->right.store(right, std::memory_order_release);
+
+					left->right.store(new_node, std::memory_order_release);
+					right->left = new_node;
+
+					list.list_size.add(1);
+					list.mutations.add(1);
+
+					iterator it(new_node, &list);
+					left->lock.unlock();
+					right->lock.unlock();
+					list.domain.exit(epoch);
+
+					add_tower(new_node, value);
+					return it;
+				}
+
+				left->lock.unlock();
+				right->lock.unlock();
+				list.domain.exit(epoch);
+			}
+		}
+
+		void erase(iterator it) {
+			value_type* node = it.value;
+			if (node->node_status != status::ACTIVE) {
+				return;
+			}
+			list.erase(it);
+			remove_tower(node, node->value);
+		}
+
+	private:
+		static constexpr std::size_t max_level = 20;
+
+		// Towers are ordered by key and, among equal keys, by node address,
+		// so every tower has a unique place even when values repeat.
+		struct tower {
+			value_type* node;
+			list_type key;
+			std::size_t top;
+			std::vector<std::atomic<tower*>> next;
+			rw_lock lock;
+			std::atomic<bool> marked = false;
+			std::atomic<bool> linked = false;
+			std::size_t retire_epoch = 0;
+			tower* retire_next = nullptr;
+
+			tower(value_type* node, const list_type& key, std::size_t height)
+				: node(node), key(key), top(height - 1), next(height) {}
+		};
+
+		using tower_path = std::array<tower*, max_level>;
+
+		List<list_type> list;
+		Compare compare;
+		tower head{ nullptr, list_type(), max_level };
+		retire_list<tower> retired{ list.domain };
+
+		// Whether the search for value has to move past key: key < value, or
+		// key <= value when searching for the upper bound.
+		bool before(const list_type& key, const list_type& value, bool upper) {
+			return upper ? !compare(value, key) : compare(key, value);
+		}
+
+		// Last node that the search for value has to move past, starting from
+		// the closest live indexed node. Must be called inside an epoch.
+		value_type* predecessor(const list_type& value, bool upper) {
+			value_type* current = list.root;
+			tower* at = &head;
+			for (std::size_t level = max_level; level-- > 0;) {
+				tower* next = at->next[level].load(std::memory_order_acquire);
+				while (next && before(next->key, value, upper)) {
+					at = next;
+					if (at->node->node_status != status::DELETED) {
+						current = at->node;
+					}
+					next = at->next[level].load(std::memory_order_acquire);
+				}
+			}
+
+			while (true) {
+				current->lock.rlock();
+				value_type* right = current->right;
+				current->lock.unlock();
+				if (right == list.last || !before(right->load(), value, upper)) {
+					return current;
+				}
+				current = right;
+			}
+		}
+
+		iterator search(const list_type& value, bool upper) {
+			while (true) {
+				std::size_t epoch = list.domain.enter();
+				value_type* left = predecessor(value, upper);
+
+				left->lock.rlock();
+				value_type* right = left->right;
+				bool valid = left->node_status != status::DELETED &&
+					(right == list.last || !before(right->load(), value, upper));
+				if (valid) {
+					iterator it(right, &list);
+					left->lock.unlock();
+					list.domain.exit(epoch);
+					return it;
+				}
+				left->lock.unlock();
+				list.domain.exit(epoch);
+			}
+		}
+
+		static std::minstd_rand& random() {
+			thread_local std::minstd_rand engine(static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+			return engine;
+		}
+
+		bool tower_before(const tower* at, const list_type& key, const value_type* node) {
+			return compare(at->key, key) ||
+				(!compare(key, at->key) && std::less<const value_type*>()(at->node, node));
+		}
+
+		// Fills in the last tower before (key, node) and the one after it on
+		// every level and returns the tower of node if it is linked on any
+		// level. Must be called inside an epoch.
+		tower* locate(const list_type& key, const value_type* node, tower_path& preds, tower_path& succs) {
+			tower* found = nullptr;
+			tower* at = &head;
+			for (std::size_t level = max_level; level-- > 0;) {
+				tower* next = at->next[level].load(std::memory_order_acquire);
+				while (next && tower_before(next, key, node)) {
+					at = next;
+					next = at->next[level].load(std::memory_order_acquire);
+				}
+				if (!found && next && next->node == node) {
+					found = next;
+				}
+				preds[level] = at;
+				succs[level] = next;
+			}
+			return found;
+		}
+
+		// Write-locks preds[0..top] bottom-up, each tower once. Locks are
+		// always taken in descending tower order, so no two updates can wait
+		// on each other.
+		void lock_path(tower_path& preds, std::size_t top) {
+			for (std::size_t level = 0; level <= top; ++level) {
+				if (level == 0 || preds[level] != preds[level - 1]) {
+					preds[level]->lock.wlock();
+				}
+			}
+		}
+
+		void unlock_path(tower_path& preds, std::size_t top) {
+			for (std::size_t level = 0; level <= top; ++level) {
+				if (level == 0 || preds[level] != preds[level - 1]) {
+					preds[level]->lock.unlock();
+				}
+			}
+		}
+
+		// Three out of four nodes get no tower and never touch the index.
+		void add_tower(value_type* node, const list_type& key) {
+			if (random()() % 4 != 0) {
+				return;
+			}
+			std::size_t top = 0;
+			while (top + 1 < max_level && random()() % 4 == 0) {
+				++top;
+			}
+
+			std::size_t epoch = list.domain.enter();
+			tower* added = nullptr;
+			tower_path preds, succs;
+			while (!added) {
+				locate(key, node, preds, succs);
+				lock_path(preds, top);
+				bool valid = true;
+				for (std::size_t level = 0; valid && level <= top; ++level) {
+					valid = !preds[level]->marked && (!succs[level] || !succs[level]->marked) &&
+						preds[level]->next[level].load() == succs[level];
+				}
+				if (valid) {
+					node->increase_ref();
+					added = new tower(node, key, top + 1);
+					for (std::size_t level = 0; level <= top; ++level) {
+						added->next[level].store(succs[level], std::memory_order_relaxed);
+					}
+					for (std::size_t level = 0; level <= top; ++level) {
+						preds[level]->next[level].store(added, std::memory_order_release);
+					}
+					added->linked = true;
+				}
+				unlock_path(preds, top);
+			}
+			list.domain.exit(epoch);
+
+			// An erase that finished before the tower was linked did not find
+			// it. Either it sees the tower or the status check here sees the
+			// erase, and unlinking twice is harmless.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (node->node_status == status::DELETED) {
+				remove_tower(node, key);
+			}
+		}
+
+		void remove_tower(value_type* node, const list_type& key) {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::size_t epoch = list.domain.enter();
+			tower_path preds, succs;
+			tower* victim = locate(key, node, preds, succs);
+			if (!victim) {
+				list.domain.exit(epoch);
+				return;
+			}
+			while (!victim->linked) {
+				cpu_relax();
+			}
+
+			victim->lock.wlock();
+			if (victim->marked) {
+				victim->lock.unlock();
+				list.domain.exit(epoch);
+				return;
+			}
+			victim->marked = true;
+
+			std::size_t top = victim->top;
+			while (true) {
+				locate(key, node, preds, succs);
+				lock_path(preds, top);
+				bool valid = true;
+				for (std::size_t level = 0; valid && level <= top; ++level) {
+					valid = !preds[level]->marked && preds[level]->next[level].load() == victim;
+				}
+				if (valid) {
+					for (std::size_t level = top + 1; level-- > 0;) {
+						preds[level]->next[level].store(victim->next[level].load(), std::memory_order_release);
+					}
+					unlock_path(preds, top);
+					break;
+				}
+				unlock_path(preds, top);
+			}
+			victim->lock.unlock();
+
+			victim->node->release();
+			retired.retire(victim);
+			list.domain.exit(epoch);
+			if (retired.ready()) {
+				retired.collect();
+			}
+		}
+	};
+}
@@ -4,11 +4,208 @@
 #include <thread>
 #include <ctime>
 #include <condition_variable>
+#include <algorithm>
+#include <deque>
+#include <mutex>
 #include "catch.hpp"
 #include "list.hpp"
+#include "lockfree_list.hpp"
+#include "unrolled_list.hpp"
+#include "sorted_list.hpp"
 
 using namespace fefu;
 
+template <typename Lock>
+long long lock_benchmark(int threadsAmount, int iterations, int writeEvery) {
+	Lock lock;
+	long long counter = 0;
+	std::vector<long long> seen(threadsAmount);
+	std::vector<std::thread> threads;
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < threadsAmount; ++i) {
+		threads.push_back(std::thread([&, i]() {
+			volatile long long sink = 0;
+			for (int j = 0; j < iterations; ++j) {
+				if (j % writeEvery == 0) {
+					lock.wlock();
+					++counter;
+					lock.unlock();
+				}
+				else {
+					lock.rlock();
+					sink = counter;
+					lock.unlock();
+				}
+			}
+			seen[i] = sink;
+			}));
+	}
+
+	for (int k = 0; k < threadsAmount; ++k) {
+		threads[k].join();
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	REQUIRE(counter == static_cast<long long>(threadsAmount) * ((iterations + writeEvery - 1) / writeEvery));
+	for (long long read : seen) {
+		REQUIRE(read <= counter);
+	}
+	return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+template <typename Lock>
+std::vector<long long> list_latency_benchmark(int readersAmount, int operations) {
+	List<int, Lock> list;
+	for (int i = 0; i < 1000; ++i) {
+		list.push_back(i);
+	}
+
+	std::atomic<bool> done = false;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < readersAmount; ++i) {
+		readers.push_back(std::thread([&]() {
+			while (!done) {
+				for (auto it = list.begin(); it != list.end() && !done; ++it) {
+					static_cast<void>(*it);
+				}
+			}
+			}));
+	}
+
+	std::vector<long long> latencies;
+	for (int j = 0; j < operations; ++j) {
+		auto start = std::chrono::high_resolution_clock::now();
+		if (j % 2 == 0) {
+			list.push_back(j);
+		}
+		else {
+			list.erase(list.begin());
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	done = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+
+	REQUIRE(list.size() == 1000);
+	REQUIRE(list.checklocks());
+	std::sort(latencies.begin(), latencies.end());
+	return { latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back() };
+}
+
+template <typename Container>
+long long list_workload(int threadsAmount, int numberOfElements) {
+	Container list;
+	std::vector<std::thread> threads;
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < threadsAmount; ++i) {
+		threads.push_back(std::thread([&](int th) {
+			for (int j = 0; j < numberOfElements / threadsAmount; ++j) {
+				list.push_back(j + th * numberOfElements / threadsAmount);
+			}
+			long long sum = 0;
+			for (auto it = list.begin(); it != list.end(); ++it) {
+				sum += *it;
+			}
+			for (int j = 0; j < numberOfElements / threadsAmount / 2; ++j) {
+				list.erase(list.begin());
+			}
+			}, i));
+	}
+
+	for (int k = 0; k < threadsAmount; ++k) {
+		threads[k].join();
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	REQUIRE(list.size() >= static_cast<size_t>(numberOfElements - numberOfElements / 2));
+	return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+// Nanoseconds per operation for erasing every second element during one
+// walk, and for erasing the last element and appending a new one.
+template <typename Container>
+std::vector<long long> positional_erase_workload(int numberOfElements) {
+	Container list;
+	for (int i = 0; i < numberOfElements; ++i) {
+		list.push_back(i);
+	}
+
+	auto startMiddle = std::chrono::high_resolution_clock::now();
+	int position = 0;
+	for (auto it = list.begin(); it != list.end(); ++position) {
+		auto next = it;
+		++next;
+		if (position % 2 == 1) {
+			list.erase(it);
+		}
+		it = next;
+	}
+	auto endMiddle = std::chrono::high_resolution_clock::now();
+	REQUIRE(list.size() == static_cast<size_t>(numberOfElements - numberOfElements / 2));
+
+	auto before = list.begin();
+	for (size_t i = 0; i + 2 < list.size(); ++i) {
+		++before;
+	}
+	int operations = 10000;
+	auto startTail = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < operations; ++i) {
+		auto it = before;
+		++it;
+		list.erase(it);
+		list.push_back(i);
+	}
+	auto endTail = std::chrono::high_resolution_clock::now();
+	REQUIRE(list.size() == static_cast<size_t>(numberOfElements - numberOfElements / 2));
+
+	return { std::chrono::duration_cast<std::chrono::nanoseconds>(endMiddle - startMiddle).count() / (numberOfElements / 2),
+		std::chrono::duration_cast<std::chrono::nanoseconds>(endTail - startTail).count() / operations };
+}
+
+template <typename T>
+void simd_scan_check() {
+	std::vector<T> values(67);
+	for (size_t i = 0; i < values.size(); ++i) {
+		values[i] = static_cast<T>(i % 50 + 1);
+	}
+	for (size_t i = 0; i < values.size(); ++i) {
+		REQUIRE(simd::find(values.data(), values.size(), values[i]) == static_cast<size_t>(std::find(values.begin(), values.end(), values[i]) - values.begin()));
+		REQUIRE(simd::count(values.data(), values.size(), values[i]) == static_cast<size_t>(std::count(values.begin(), values.end(), values[i])));
+	}
+	REQUIRE(simd::find(values.data(), values.size(), static_cast<T>(0)) == values.size());
+	REQUIRE(simd::count(values.data(), values.size(), static_cast<T>(0)) == 0);
+}
+
+// Counts live instances, so a test can tell whether erased nodes were freed.
+struct tracked {
+	static inline std::atomic<int> alive = 0;
+	int value;
+
+	tracked(int value = 0) : value(value) {
+		++alive;
+	}
+
+	tracked(const tracked& other) : value(other.value) {
+		++alive;
+	}
+
+	tracked& operator=(const tracked&) = default;
+
+	~tracked() {
+		--alive;
+	}
+
+	bool operator==(const tracked& other) const {
+		return value == other.value;
+	}
+};
+
 TEST_CASE("TEST") {
 	SECTION("LOCK TEST") {
 		rw_lock lock;
@@ -416,4 +613,1511 @@ TEST_CASE("TEST") {
 			}
 		}
 	}
-}
\ No newline at end of file
+	SECTION("RECLAMATION TEST") {
+		std::cout << "RECLAMATION TEST" << std::endl;
+		int numberOfElements = 10000;
+		int threadsAmount = 4;
+		{
+			List<tracked> list;
+			for (int i = 0; i < numberOfElements; ++i) {
+				list.push_back(i);
+			}
+
+			{
+				auto held = list.find(numberOfElements / 2);
+				list.erase(held);
+
+				std::vector<std::thread> threads;
+				for (int i = 0; i < threadsAmount; ++i) {
+					threads.push_back(std::thread([&]() {
+						while (!list.empty()) {
+							auto it = list.begin();
+							list.erase(it);
+							auto last = list.end();
+							--last;
+							list.erase(last);
+						}
+						}));
+				}
+
+				for (int k = 0; k < threadsAmount; ++k) {
+					threads[k].join();
+				}
+
+				REQUIRE(held.get().value == numberOfElements / 2);
+				REQUIRE(list.empty());
+				auto last = list.end();
+				while (held != last) {
+					++held;
+				}
+			}
+
+			// Unlinks count towards the collect threshold, so further use of
+			// the list frees the chain of erased nodes the held iterator
+			// pinned; only the sentinels and a threshold's worth may remain.
+			for (int i = 0; i < 200; ++i) {
+				list.push_back(i);
+				list.pop_front();
+			}
+			std::cout << "ALIVE AFTER ERASING " << numberOfElements << ": " << tracked::alive << std::endl;
+			REQUIRE(tracked::alive < 100);
+		}
+		REQUIRE(tracked::alive == 0);
+	}
+	SECTION("CONSTRUCTION SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "CONSTRUCTION SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / NUMBER OF THREADS / MICROSECONDS PER LIST" << std::endl;
+
+		int numberOfLists = 1000;
+		for (int numberOfElements = 0; numberOfElements <= 1000; numberOfElements = (numberOfElements == 0) ? 10 : numberOfElements * 10) {
+			for (int threadsAmount = 1; threadsAmount <= 4; threadsAmount *= 2) {
+				std::vector<std::thread> threads;
+				auto startThreaded = std::chrono::high_resolution_clock::now();
+
+				for (int i = 0; i < threadsAmount; ++i) {
+					threads.push_back(std::thread([&]() {
+						for (int j = 0; j < numberOfLists / threadsAmount; ++j) {
+							List<int> list;
+							for (int k = 0; k < numberOfElements; ++k) {
+								list.push_back(k);
+							}
+						}
+						}));
+				}
+
+				for (int k = 0; k < threadsAmount; ++k) {
+					threads[k].join();
+				}
+
+				auto endThreaded = std::chrono::high_resolution_clock::now();
+				auto timeThreaded = std::chrono::duration_cast<std::chrono::microseconds>(endThreaded - startThreaded);
+
+				std::cout << numberOfElements << "        " << threadsAmount << "        " << static_cast<double>(timeThreaded.count()) / numberOfLists << std::endl;
+			}
+		}
+	}
+	SECTION("SLAB ALLOCATION TEST") {
+		std::cout << "SLAB ALLOCATION TEST" << std::endl;
+		int threadsAmount = 4;
+		int numberOfElements = 5000;
+
+		for (int round = 0; round < 3; ++round) {
+			List<int> list;
+			std::vector<std::thread> threads;
+
+			for (int i = 0; i < threadsAmount; ++i) {
+				threads.push_back(std::thread([&](int th) {
+					for (int j = 0; j < numberOfElements; ++j) {
+						list.push_back(j + th * numberOfElements);
+					}
+					}, i));
+			}
+
+			for (int k = 0; k < threadsAmount; ++k) {
+				threads[k].join();
+			}
+
+			REQUIRE(list.size() == static_cast<size_t>(threadsAmount * numberOfElements));
+
+			for (int j = 0; j < numberOfElements; ++j) {
+				auto it = list.begin();
+				list.erase(it);
+				list.push_front(j);
+			}
+
+			REQUIRE(list.size() == static_cast<size_t>(threadsAmount * numberOfElements));
+			REQUIRE(*list.begin() == numberOfElements - 1);
+		}
+	}
+	SECTION("LOCK SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "LOCK SPEED TEST" << std::endl;
+		std::cout << "CASE / NUMBER OF THREADS / RW_LOCK / PARKING_RW_LOCK (MICROSECONDS)" << std::endl;
+
+		int hardware = std::max(1u, std::thread::hardware_concurrency());
+		int iterations = 200000;
+		std::vector<std::pair<std::string, int>> cases = {
+			{ "uncontended", 1 },
+			{ "moderate", std::max(2, hardware / 2) },
+			{ "oversubscribed", hardware * 4 },
+		};
+
+		for (auto& c : cases) {
+			int perThread = iterations / c.second;
+			auto spinning = lock_benchmark<rw_lock>(c.second, perThread, 10);
+			auto parking = lock_benchmark<parking_rw_lock>(c.second, perThread, 10);
+			std::cout << c.first << "        " << c.second << "        " << spinning << "        " << parking << std::endl;
+		}
+	}
+	SECTION("PHASE-FAIR LOCK TEST") {
+		std::cout << "PHASE-FAIR LOCK TEST" << std::endl;
+		phase_fair_rw_lock lock;
+		int value = 0;
+		int threadsAmount = 4;
+		int numberOfOperations = 20000;
+		std::vector<int> seen(threadsAmount);
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				volatile int copy = 0;
+				for (int j = 0; j < numberOfOperations; ++j) {
+					if ((j + th) % 4 == 0) {
+						lock.wlock();
+						++value;
+						lock.unlock();
+					}
+					else {
+						lock.rlock();
+						copy = value;
+						lock.unlock();
+					}
+				}
+				seen[th] = copy;
+				}, i));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		REQUIRE(value == threadsAmount * numberOfOperations / 4);
+		for (int read : seen) {
+			REQUIRE(read <= value);
+		}
+		REQUIRE(lock.is_free());
+
+		List<int, phase_fair_rw_lock> list({ 1, 2, 3 });
+		auto it = list.find(2);
+		list.insert(it, 5);
+		list.erase(list.find(1));
+		list.push_front(0);
+		it = list.begin();
+		REQUIRE(*it == 0);
+		REQUIRE(*(++it) == 2);
+		REQUIRE(*(++it) == 5);
+		REQUIRE(list.size() == 4);
+		REQUIRE(list.checklocks());
+	}
+	SECTION("WRITER LATENCY TEST") {
+		std::cout << std::endl;
+		std::cout << "WRITER LATENCY TEST" << std::endl;
+		std::cout << "LOCK / NUMBER OF READERS / P50 / P99 / MAX (NANOSECONDS)" << std::endl;
+
+		int operations = 20000;
+		for (int readersAmount = 1; readersAmount <= 4; readersAmount *= 2) {
+			auto spinning = list_latency_benchmark<rw_lock>(readersAmount, operations);
+			std::cout << "rw_lock" << "        " << readersAmount << "        " << spinning[0] << "        " << spinning[1] << "        " << spinning[2] << std::endl;
+			auto fair = list_latency_benchmark<phase_fair_rw_lock>(readersAmount, operations);
+			std::cout << "phase_fair_rw_lock" << "        " << readersAmount << "        " << fair[0] << "        " << fair[1] << "        " << fair[2] << std::endl;
+		}
+	}
+	SECTION("SEQLOCK READ TEST") {
+		std::cout << "SEQLOCK READ TEST" << std::endl;
+		struct pair_value {
+			long long first;
+			long long second;
+		};
+
+		List<pair_value> list({ { 0, 0 }, { 0, 0 } });
+		std::atomic<bool> done = false;
+		std::atomic<int> torn = 0;
+		int readersAmount = 3;
+		int numberOfWrites = 100000;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < readersAmount; ++i) {
+			threads.push_back(std::thread([&]() {
+				auto it = list.begin();
+				while (!done) {
+					pair_value value = *it;
+					if (value.first != value.second) {
+						++torn;
+					}
+				}
+				}));
+		}
+
+		auto it = list.begin();
+		for (long long j = 1; j <= numberOfWrites; ++j) {
+			it.set({ j, j });
+		}
+		done = true;
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		REQUIRE(torn == 0);
+		REQUIRE(it.get().first == numberOfWrites);
+		REQUIRE(list.checklocks());
+
+		List<std::string> strings({ "a", "b" });
+		auto sit = strings.begin();
+		sit.set("c");
+		REQUIRE(*sit == "c");
+	}
+	SECTION("LOCK-FREE LIST TEST") {
+		std::cout << "LOCK-FREE LIST TEST" << std::endl;
+		LockFreeList<int> list({ 1, 2, 3 });
+		list.push_front(0);
+		auto it = list.find(2);
+		list.insert(it, 5);
+		list.erase(list.find(1));
+		it.set(4);
+
+		std::vector<int> values;
+		for (auto i = list.begin(); i != list.end(); ++i) {
+			values.push_back(*i);
+		}
+		REQUIRE(values == std::vector<int>({ 0, 4, 5, 3 }));
+		REQUIRE(list.size() == 4);
+		REQUIRE(bool(list.find(1) == list.end()));
+
+		LockFreeList<int> shared;
+		int threadsAmount = 4;
+		int numberOfElements = 20000;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&]() {
+				for (int j = 0; j < numberOfElements; ++j) {
+					shared.push_back(j);
+					if (j % 2 == 0) {
+						shared.erase(shared.begin());
+					}
+				}
+				}));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		size_t counted = 0;
+		for (auto i = shared.begin(); i != shared.end(); ++i) {
+			++counted;
+		}
+		REQUIRE(shared.size() >= static_cast<size_t>(threadsAmount * numberOfElements / 2));
+		REQUIRE(counted == shared.size());
+
+		list.pop_back();
+		list.pop_back();
+		values.clear();
+		for (auto i = list.begin(); i != list.end(); ++i) {
+			values.push_back(*i);
+		}
+		REQUIRE(values == std::vector<int>({ 0, 4 }));
+		list.push_back(7);
+		REQUIRE(*list.find(7) == 7);
+		list.pop_back();
+		list.pop_back();
+		list.pop_back();
+		list.pop_back();
+		REQUIRE(list.empty());
+		REQUIRE(bool(list.begin() == list.end()));
+
+		LockFreeList<int> stack;
+		threads.clear();
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&]() {
+				for (int j = 0; j < numberOfElements / 10; ++j) {
+					stack.push_back(j);
+					if (j % 2 == 0) {
+						stack.pop_back();
+					}
+				}
+				}));
+		}
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+		counted = 0;
+		for (auto i = stack.begin(); i != stack.end(); ++i) {
+			++counted;
+		}
+		REQUIRE(stack.size() == static_cast<size_t>(threadsAmount * numberOfElements / 20));
+		REQUIRE(counted == stack.size());
+	}
+	SECTION("LOCK-FREE LIST SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "LOCK-FREE LIST SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / LIST / LOCKFREELIST (MILLISECONDS)" << std::endl;
+
+		int numberOfElements = 100000;
+		for (int threadsAmount = 1; threadsAmount <= 32; threadsAmount *= 2) {
+			auto locked = list_workload<List<int>>(threadsAmount, numberOfElements);
+			auto lockfree = list_workload<LockFreeList<int>>(threadsAmount, numberOfElements);
+			std::cout << threadsAmount << "        " << locked << "        " << lockfree << std::endl;
+		}
+	}
+	SECTION("LOCK-FREE LIST ERASE SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "LOCK-FREE LIST ERASE SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / LIST MIDDLE / LOCKFREELIST MIDDLE / LIST TAIL / LOCKFREELIST TAIL (NANOSECONDS PER ERASE)" << std::endl;
+
+		for (int numberOfElements = 1000; numberOfElements <= 100000; numberOfElements *= 10) {
+			auto locked = positional_erase_workload<List<int>>(numberOfElements);
+			auto lockfree = positional_erase_workload<LockFreeList<int>>(numberOfElements);
+			std::cout << numberOfElements << "        " << locked[0] << "        " << lockfree[0] << "        "
+				<< locked[1] << "        " << lockfree[1] << std::endl;
+		}
+	}
+	SECTION("UNROLLED LIST TEST") {
+		std::cout << "UNROLLED LIST TEST" << std::endl;
+		UnrolledList<int, 4> list({ 1, 2, 3 });
+		list.push_front(0);
+		for (int i = 4; i < 10; ++i) {
+			list.push_back(i);
+		}
+		auto it = list.find(2);
+		list.insert(it, 20);
+		it = list.find(2);
+		list.insert(it, 21);
+		list.erase(list.find(1));
+		it = list.find(8);
+		it.set(80);
+
+		std::vector<int> values;
+		for (auto i = list.begin(); i != list.end(); ++i) {
+			values.push_back(*i);
+		}
+		REQUIRE(values == std::vector<int>({ 0, 2, 21, 20, 3, 4, 5, 6, 7, 80, 9 }));
+		REQUIRE(list.size() == 11);
+		REQUIRE(bool(list.find(1) == list.end()));
+
+		while (!list.empty()) {
+			list.erase(list.begin());
+		}
+		REQUIRE(bool(list.begin() == list.end()));
+		REQUIRE(list.checklocks());
+
+		UnrolledList<int> shared;
+		int threadsAmount = 4;
+		int numberOfElements = 20000;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&]() {
+				for (int j = 0; j < numberOfElements; ++j) {
+					if (j % 3 == 0) {
+						shared.push_front(j);
+					}
+					else {
+						shared.push_back(j);
+					}
+					if (j % 2 == 0) {
+						shared.erase(shared.begin());
+					}
+				}
+				}));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		size_t counted = 0;
+		for (auto i = shared.begin(); i != shared.end(); ++i) {
+			++counted;
+		}
+		REQUIRE(shared.size() >= static_cast<size_t>(threadsAmount * numberOfElements / 2));
+		REQUIRE(counted == shared.size());
+		REQUIRE(shared.checklocks());
+	}
+	SECTION("UNROLLED LIST SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "UNROLLED LIST SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / LIST ITERATE / UNROLLED ITERATE / LIST FIND / UNROLLED FIND (MICROSECONDS)" << std::endl;
+
+		for (int numberOfElements = 10000; numberOfElements <= 1000000; numberOfElements *= 10) {
+			List<int> list;
+			UnrolledList<int> unrolled;
+			for (int i = 0; i < numberOfElements; ++i) {
+				list.push_back(i);
+				unrolled.push_back(i);
+			}
+
+			auto time = [](auto function) {
+				auto start = std::chrono::high_resolution_clock::now();
+				function();
+				auto end = std::chrono::high_resolution_clock::now();
+				return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+			};
+
+			long long listSum = 0, unrolledSum = 0;
+			auto listIterate = time([&]() {
+				for (auto it = list.begin(); it != list.end(); ++it) {
+					listSum += *it;
+				}
+				});
+			auto unrolledIterate = time([&]() {
+				for (auto it = unrolled.begin(); it != unrolled.end(); ++it) {
+					unrolledSum += *it;
+				}
+				});
+			auto listFind = time([&]() {
+				REQUIRE(bool(list.find(-1) == list.end()));
+				});
+			auto unrolledFind = time([&]() {
+				REQUIRE(bool(unrolled.find(-1) == unrolled.end()));
+				});
+
+			REQUIRE(listSum == unrolledSum);
+			std::cout << numberOfElements << "        " << listIterate << "        " << unrolledIterate << "        " << listFind << "        " << unrolledFind << std::endl;
+		}
+	}
+	SECTION("SIMD FIND TEST") {
+		std::cout << "SIMD FIND TEST" << std::endl;
+		simd_scan_check<char>();
+		simd_scan_check<short>();
+		simd_scan_check<int>();
+		simd_scan_check<unsigned>();
+		simd_scan_check<long long>();
+		simd_scan_check<float>();
+		simd_scan_check<double>();
+
+		UnrolledList<int> unrolled;
+		List<int> list;
+		for (int i = 0; i < 1000; ++i) {
+			unrolled.push_back(i % 7);
+			list.push_back(i % 7);
+		}
+		REQUIRE(unrolled.count(3) == 143);
+		REQUIRE(list.count(3) == 143);
+		REQUIRE(*unrolled.find(6) == 6);
+		REQUIRE(unrolled.count(7) == 0);
+	}
+	SECTION("SIMD FIND SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "SIMD FIND SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / LIST COUNT / UNROLLED COUNT / UNROLLED FIND (MICROSECONDS)" << std::endl;
+
+		for (int numberOfElements = 100000; numberOfElements <= 4000000; numberOfElements *= 4) {
+			List<int> list;
+			UnrolledList<int> unrolled;
+			for (int i = 0; i < numberOfElements; ++i) {
+				list.push_back(i % 1000);
+				unrolled.push_back(i % 1000);
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			auto listCount = list.count(999);
+			auto middle = std::chrono::high_resolution_clock::now();
+			auto unrolledCount = unrolled.count(999);
+			auto end = std::chrono::high_resolution_clock::now();
+			REQUIRE(bool(unrolled.find(-1) == unrolled.end()));
+			auto found = std::chrono::high_resolution_clock::now();
+
+			REQUIRE(listCount == unrolledCount);
+			std::cout << numberOfElements << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(found - end).count() << std::endl;
+		}
+	}
+	SECTION("SORTED LIST TEST") {
+		std::cout << "SORTED LIST TEST" << std::endl;
+		SortedList<int> list({ 5, 1, 4, 2, 3 });
+		list.insert(3);
+
+		std::vector<int> values;
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			values.push_back(*it);
+		}
+		REQUIRE(values == std::vector<int>({ 1, 2, 3, 3, 4, 5 }));
+		REQUIRE(*list.lower_bound(3) == 3);
+		REQUIRE(*list.upper_bound(3) == 4);
+		REQUIRE(bool(list.upper_bound(5) == list.end()));
+		REQUIRE(list.contains(4));
+		REQUIRE(!list.contains(6));
+
+		list.erase(list.find(3));
+		list.erase(list.find(3));
+		REQUIRE(!list.contains(3));
+		REQUIRE(list.size() == 4);
+
+		SortedList<int> shared;
+		int threadsAmount = 4;
+		int numberOfElements = 20000;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				for (int j = 0; j < numberOfElements; ++j) {
+					shared.insert(j * threadsAmount + th);
+					if (j % 2 == 1) {
+						shared.erase(shared.find((j - 1) * threadsAmount + th));
+					}
+				}
+				}, i));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		REQUIRE(shared.size() == static_cast<size_t>(threadsAmount * numberOfElements / 2));
+		int previous = -1;
+		size_t counted = 0;
+		for (auto it = shared.begin(); it != shared.end(); ++it) {
+			REQUIRE(previous < *it);
+			REQUIRE((*it / threadsAmount) % 2 == 1);
+			previous = *it;
+			++counted;
+		}
+		REQUIRE(counted == shared.size());
+
+		SortedList<int> repeated;
+		std::atomic<int> missed = 0;
+		threads.clear();
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&]() {
+				for (int j = 0; j < numberOfElements; ++j) {
+					auto it = repeated.insert(j % 64);
+					if (*repeated.lower_bound(j % 64) != j % 64) {
+						++missed;
+					}
+					repeated.erase(it);
+				}
+				}));
+		}
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+		REQUIRE(missed == 0);
+		REQUIRE(repeated.empty());
+		REQUIRE(bool(repeated.lower_bound(0) == repeated.end()));
+	}
+	SECTION("SORTED LIST SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "SORTED LIST SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / LIST FIND / SORTED FIND / SORTED INSERT (MICROSECONDS PER OPERATION)" << std::endl;
+
+		for (int numberOfElements = 1000; numberOfElements <= 100000; numberOfElements *= 10) {
+			List<int> list;
+			SortedList<int> sorted;
+			std::vector<int> keys(numberOfElements);
+			std::iota(keys.begin(), keys.end(), 0);
+			std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+			auto startInsert = std::chrono::high_resolution_clock::now();
+			for (int key : keys) {
+				sorted.insert(key);
+			}
+			auto endInsert = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < numberOfElements; ++i) {
+				list.push_back(i);
+			}
+
+			int lookups = 1000;
+			auto startList = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < lookups; ++i) {
+				REQUIRE(*list.find(keys[i]) == keys[i]);
+			}
+			auto startSorted = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < lookups; ++i) {
+				REQUIRE(*sorted.find(keys[i]) == keys[i]);
+			}
+			auto endSorted = std::chrono::high_resolution_clock::now();
+
+			std::cout << numberOfElements << "        "
+				<< static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(startSorted - startList).count()) / lookups << "        "
+				<< static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(endSorted - startSorted).count()) / lookups << "        "
+				<< static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(endInsert - startInsert).count()) / numberOfElements << std::endl;
+		}
+	}
+	SECTION("POSITIONAL INDEX TEST") {
+		std::cout << "POSITIONAL INDEX TEST" << std::endl;
+		List<int> list;
+		int numberOfElements = 1000;
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(i);
+		}
+
+		for (int i = 0; i < numberOfElements; i += 37) {
+			REQUIRE(*list.at(i) == i);
+		}
+		REQUIRE(bool(list.at(numberOfElements) == list.end()));
+
+		auto it = list.begin();
+		it.advance(10);
+		REQUIRE(*it == 10);
+		it.advance(500);
+		REQUIRE(*it == 510);
+		it.advance(numberOfElements);
+		REQUIRE(bool(it == list.end()));
+
+		list.erase(list.at(0));
+		list.push_front(-1);
+		list.erase(list.find(500));
+		REQUIRE(*list.at(0) == -1);
+		REQUIRE(*list.at(500) == 501);
+
+		auto points = list.split_points(4);
+		REQUIRE(points.size() == 5);
+		REQUIRE(bool(points[0] == list.begin()));
+		REQUIRE(*points[2] == 499);
+		REQUIRE(bool(points[4] == list.end()));
+
+		List<int> empty;
+		REQUIRE(bool(empty.at(0) == empty.end()));
+		REQUIRE(empty.split_points(2).size() == 3);
+
+		// The checkpoints must not keep erased nodes alive.
+		{
+			List<tracked> indexed;
+			for (int i = 0; i < 10000; ++i) {
+				indexed.push_back(i);
+			}
+			REQUIRE((*indexed.at(5000)).value == 5000);
+			indexed.clear();
+			for (int i = 0; i < 200; ++i) {
+				indexed.push_back(i);
+				indexed.pop_front();
+			}
+			REQUIRE(tracked::alive < 100);
+		}
+		REQUIRE(tracked::alive == 0);
+	}
+	SECTION("POSITIONAL INDEX SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "POSITIONAL INDEX SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF ELEMENTS / ITERATE TO SPLITS / SPLIT_POINTS / AT / AT AFTER ONE INSERT (MICROSECONDS)" << std::endl;
+
+		int workers = 8;
+		for (int numberOfElements = 10000; numberOfElements <= 1000000; numberOfElements *= 10) {
+			List<int> list;
+			for (int i = 0; i < numberOfElements; ++i) {
+				list.push_back(i);
+			}
+			list.at(0);
+
+			auto startWalk = std::chrono::high_resolution_clock::now();
+			for (int w = 0; w < workers; ++w) {
+				auto it = list.begin();
+				for (int j = 0; j < numberOfElements / workers * w; ++j) {
+					++it;
+				}
+				REQUIRE(*it == numberOfElements / workers * w);
+			}
+			auto startSplit = std::chrono::high_resolution_clock::now();
+			auto points = list.split_points(workers);
+			auto startAt = std::chrono::high_resolution_clock::now();
+			for (int w = 0; w < workers; ++w) {
+				REQUIRE(*list.at(numberOfElements / workers * w + 7) == numberOfElements / workers * w + 7);
+			}
+			auto endAt = std::chrono::high_resolution_clock::now();
+
+			// Any mutation makes the next lookup rebuild the index with a
+			// full walk.
+			list.push_back(numberOfElements);
+			auto startCold = std::chrono::high_resolution_clock::now();
+			REQUIRE(*list.at(numberOfElements / 2) == numberOfElements / 2);
+			auto endCold = std::chrono::high_resolution_clock::now();
+
+			REQUIRE(*points[workers / 2] == numberOfElements / 2);
+			std::cout << numberOfElements << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(startSplit - startWalk).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(startAt - startSplit).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(endAt - startAt).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(endCold - startCold).count() << std::endl;
+		}
+	}
+	SECTION("STRIPED SIZE TEST") {
+		std::cout << "STRIPED SIZE TEST" << std::endl;
+		List<int> list;
+		int threadsAmount = 8;
+		int numberOfElements = 10000;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&]() {
+				for (int j = 0; j < numberOfElements; ++j) {
+					list.push_back(j);
+					if (j % 4 == 0) {
+						list.push_front(j);
+					}
+				}
+				}));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		size_t expected = static_cast<size_t>(threadsAmount) * (numberOfElements + numberOfElements / 4);
+		REQUIRE(list.size() == expected);
+		REQUIRE(list.approx_size() + 16 * 64 >= expected);
+		REQUIRE(list.approx_size() <= expected + 16 * 64);
+
+		while (!list.empty()) {
+			list.erase(list.begin());
+		}
+		REQUIRE(list.size() == 0);
+		REQUIRE(list.approx_size() <= 16 * 64);
+	}
+	SECTION("STRIPED COUNTER SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "STRIPED COUNTER SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / ATOMIC / STRIPED (MICROSECONDS)" << std::endl;
+
+		int numberOfAdds = 1000000;
+		for (int threadsAmount = 1; threadsAmount <= 8; threadsAmount *= 2) {
+			std::atomic<std::ptrdiff_t> single = 0;
+			striped_counter striped;
+
+			auto run = [&](auto add) {
+				std::vector<std::thread> threads;
+				auto start = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < threadsAmount; ++i) {
+					threads.push_back(std::thread([&]() {
+						for (int j = 0; j < numberOfAdds / threadsAmount; ++j) {
+							add();
+						}
+						}));
+				}
+				for (auto& thread : threads) {
+					thread.join();
+				}
+				auto end = std::chrono::high_resolution_clock::now();
+				return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+			};
+
+			auto atomicTime = run([&]() { ++single; });
+			auto stripedTime = run([&]() { striped.add(1); });
+			REQUIRE(single == striped.sum());
+			std::cout << threadsAmount << "        " << atomicTime << "        " << stripedTime << std::endl;
+		}
+	}
+	SECTION("APPEND_RANGE/SPLICE TEST") {
+		std::cout << "APPEND_RANGE/SPLICE TEST" << std::endl;
+		List<int> list({ 1, 2 });
+		std::vector<int> batch = { 3, 4, 5 };
+		list.append_range(batch.begin(), batch.end());
+		list.append_range(batch.end(), batch.end());
+
+		List<int> other({ 6, 7 });
+		list.splice(other);
+		REQUIRE(other.empty());
+		REQUIRE(bool(other.begin() == other.end()));
+		other.push_back(8);
+		list.splice(other);
+		list.splice(other);
+
+		std::vector<int> values;
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			values.push_back(*it);
+		}
+		REQUIRE(values == std::vector<int>({ 1, 2, 3, 4, 5, 6, 7, 8 }));
+		REQUIRE(list.size() == 8);
+		auto it = list.end();
+		--it;
+		REQUIRE(*it == 8);
+		list.erase(list.find(6));
+		list.pop_back();
+		REQUIRE(list.size() == 6);
+		REQUIRE(list.checklocks());
+
+		List<int> shared;
+		int threadsAmount = 4;
+		int numberOfBatches = 200;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				std::vector<int> values(50, th);
+				for (int j = 0; j < numberOfBatches; ++j) {
+					if (j % 2 == 0) {
+						shared.append_range(values.begin(), values.end());
+					}
+					else {
+						List<int> local;
+						local.append_range(values.begin(), values.end());
+						shared.splice(local);
+					}
+				}
+				}, i));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		size_t counted = 0;
+		for (auto i = shared.begin(); i != shared.end(); ++i) {
+			++counted;
+		}
+		REQUIRE(shared.size() == static_cast<size_t>(threadsAmount * numberOfBatches * 50));
+		REQUIRE(counted == shared.size());
+	}
+	SECTION("BATCH INGESTION SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "BATCH INGESTION SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / BATCH SIZE / PUSH_BACK / APPEND_RANGE (MILLION ELEMENTS PER SECOND)" << std::endl;
+
+		int numberOfElements = 1000000;
+		for (int threadsAmount = 1; threadsAmount <= 4; threadsAmount *= 2) {
+			for (int batchSize = 100; batchSize <= 10000; batchSize *= 10) {
+				auto run = [&](bool batched) {
+					List<int> list;
+					std::vector<std::thread> threads;
+					auto start = std::chrono::high_resolution_clock::now();
+					for (int i = 0; i < threadsAmount; ++i) {
+						threads.push_back(std::thread([&]() {
+							std::vector<int> values(batchSize);
+							std::iota(values.begin(), values.end(), 0);
+							for (int j = 0; j < numberOfElements / threadsAmount / batchSize; ++j) {
+								if (batched) {
+									list.append_range(values.begin(), values.end());
+								}
+								else {
+									for (int value : values) {
+										list.push_back(value);
+									}
+								}
+							}
+							}));
+					}
+					for (auto& thread : threads) {
+						thread.join();
+					}
+					auto end = std::chrono::high_resolution_clock::now();
+					REQUIRE(list.size() == static_cast<size_t>(numberOfElements / threadsAmount / batchSize * batchSize * threadsAmount));
+					return list.size() / static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+				};
+
+				auto single = run(false);
+				auto batched = run(true);
+				std::cout << threadsAmount << "        " << batchSize << "        " << single << "        " << batched << std::endl;
+			}
+		}
+	}
+	SECTION("CONCURRENT PUSH_BACK TEST") {
+		std::cout << "CONCURRENT PUSH_BACK TEST" << std::endl;
+		List<int> list;
+		int threadsAmount = 8;
+		int numberOfElements = 10000;
+		std::atomic<int> popped = 0;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadsAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				for (int j = 0; j < numberOfElements; ++j) {
+					list.push_back(th * numberOfElements + j);
+					int value = 0;
+					if (j % 10 == 0 && list.try_pop_front(value)) {
+						++popped;
+					}
+				}
+				}, i));
+		}
+
+		for (int k = 0; k < threadsAmount; ++k) {
+			threads[k].join();
+		}
+
+		std::vector<int> lastSeen(threadsAmount, -1);
+		size_t counted = 0;
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			int th = *it / numberOfElements;
+			REQUIRE(lastSeen[th] < *it);
+			lastSeen[th] = *it;
+			++counted;
+		}
+		REQUIRE(popped == threadsAmount * numberOfElements / 10);
+		REQUIRE(counted == list.size());
+		REQUIRE(list.size() == static_cast<size_t>(threadsAmount * numberOfElements - popped));
+		REQUIRE(list.checklocks());
+	}
+	SECTION("PUSH SCALING TEST") {
+		std::cout << std::endl;
+		std::cout << "PUSH SCALING TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / PUSH_FRONT / PUSH_BACK (MILLION ELEMENTS PER SECOND)" << std::endl;
+
+		int numberOfElements = 400000;
+		for (int threadsAmount = 1; threadsAmount <= 16; threadsAmount *= 2) {
+			auto run = [&](bool front) {
+				List<int> list;
+				std::vector<std::thread> threads;
+				auto start = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < threadsAmount; ++i) {
+					threads.push_back(std::thread([&]() {
+						for (int j = 0; j < numberOfElements / threadsAmount; ++j) {
+							if (front) {
+								list.push_front(j);
+							}
+							else {
+								list.push_back(j);
+							}
+						}
+						}));
+				}
+				for (auto& thread : threads) {
+					thread.join();
+				}
+				auto end = std::chrono::high_resolution_clock::now();
+				REQUIRE(list.size() == static_cast<size_t>(numberOfElements / threadsAmount * threadsAmount));
+				return list.size() / static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+			};
+
+			auto front = run(true);
+			auto back = run(false);
+			std::cout << threadsAmount << "        " << front << "        " << back << std::endl;
+		}
+	}
+	SECTION("POP_FRONT/QUEUE TEST") {
+		std::cout << "POP_FRONT/QUEUE TEST" << std::endl;
+		List<int> list{ 1, 2, 3, 4, 5, 6 };
+		list.pop_front();
+		REQUIRE(*list.begin() == 2);
+
+		int value = 0;
+		REQUIRE(list.try_pop_front(value));
+		REQUIRE(value == 2);
+		REQUIRE(list.try_pop_front_batch(2) == std::vector<int>{ 3, 4 });
+		REQUIRE(list.try_pop_front_batch(10) == std::vector<int>{ 5, 6 });
+		REQUIRE(!list.try_pop_front(value));
+		REQUIRE(list.try_pop_front_batch(3).empty());
+		REQUIRE(list.empty());
+		REQUIRE(bool(list.begin() == list.end()));
+
+		int producersAmount = 4;
+		int consumersAmount = 4;
+		int numberOfElements = 20000;
+		std::vector<std::atomic<int>> seen(producersAmount * numberOfElements);
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < consumersAmount; ++i) {
+			threads.push_back(std::thread([&](int th) {
+				while (true) {
+					std::vector<int> values;
+					if (th % 2 == 0) {
+						values.push_back(list.wait_pop_front());
+					}
+					else {
+						values = list.wait_pop_front_batch(16);
+					}
+					for (int taken : values) {
+						if (taken < 0) {
+							return;
+						}
+						++seen[taken];
+					}
+				}
+				}, i));
+		}
+		std::vector<std::thread> producers;
+		for (int i = 0; i < producersAmount; ++i) {
+			producers.push_back(std::thread([&](int th) {
+				for (int j = 0; j < numberOfElements; ++j) {
+					if (j % 2 == 0) {
+						list.push_back(th * numberOfElements + j);
+					}
+					else {
+						list.push_front(th * numberOfElements + j);
+					}
+				}
+				}, i));
+		}
+		for (auto& producer : producers) {
+			producer.join();
+		}
+		while (!list.empty()) {
+			std::this_thread::yield();
+		}
+		for (int i = 0; i < consumersAmount * 16; ++i) {
+			list.push_back(-1);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		for (auto& count : seen) {
+			REQUIRE(count == 1);
+		}
+		REQUIRE(list.checklocks());
+	}
+	SECTION("QUEUE SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "QUEUE SPEED TEST" << std::endl;
+		std::cout << "PRODUCERS / CONSUMERS / MUTEX+DEQUE / LIST / LIST BATCH 16 (MILLION ELEMENTS PER SECOND)" << std::endl;
+
+		int numberOfElements = 400000;
+		for (int producersAmount = 1; producersAmount <= 4; producersAmount *= 2) {
+			for (int consumersAmount = 1; consumersAmount <= 4; consumersAmount *= 2) {
+				auto run = [&](auto push, auto pop) {
+					std::vector<std::thread> threads;
+					auto start = std::chrono::high_resolution_clock::now();
+					for (int i = 0; i < consumersAmount; ++i) {
+						threads.push_back(std::thread([&]() {
+							while (pop()) {}
+							}));
+					}
+					std::vector<std::thread> producers;
+					for (int i = 0; i < producersAmount; ++i) {
+						producers.push_back(std::thread([&]() {
+							for (int j = 0; j < numberOfElements / producersAmount; ++j) {
+								push(j);
+							}
+							}));
+					}
+					for (auto& producer : producers) {
+						producer.join();
+					}
+					for (int i = 0; i < consumersAmount * 16; ++i) {
+						push(-1);
+					}
+					for (auto& thread : threads) {
+						thread.join();
+					}
+					auto end = std::chrono::high_resolution_clock::now();
+					return numberOfElements / static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+				};
+
+				std::mutex mutex;
+				std::condition_variable ready;
+				std::deque<int> deque;
+				auto locked = run([&](int value) {
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						deque.push_back(value);
+					}
+					ready.notify_one();
+					}, [&]() {
+						std::unique_lock<std::mutex> lock(mutex);
+						ready.wait(lock, [&]() { return !deque.empty(); });
+						int value = deque.front();
+						deque.pop_front();
+						return value >= 0;
+					});
+
+				List<int> list;
+				auto single = run([&](int value) { list.push_back(value); }, [&]() { return list.wait_pop_front() >= 0; });
+
+				List<int> batchList;
+				auto batched = run([&](int value) { batchList.push_back(value); }, [&]() {
+					for (int value : batchList.wait_pop_front_batch(16)) {
+						if (value < 0) {
+							return false;
+						}
+					}
+					return true;
+					});
+
+				std::cout << producersAmount << "        " << consumersAmount << "        " << locked << "        " << single << "        " << batched << std::endl;
+			}
+		}
+	}
+	SECTION("CURSOR TEST") {
+		std::cout << "CURSOR TEST" << std::endl;
+		List<int> list;
+		int numberOfElements = 10000;
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(i);
+		}
+
+		long long sum = 0;
+		int counted = 0;
+		for (auto cursor = list.scan(); !cursor.done(); ++cursor) {
+			sum += *cursor;
+			++counted;
+		}
+		REQUIRE(counted == numberOfElements);
+		REQUIRE(sum == static_cast<long long>(numberOfElements) * (numberOfElements - 1) / 2);
+
+		{
+			auto cursor = list.scan(1);
+			++cursor;
+			list.erase(cursor.position());
+			REQUIRE(*cursor == 1);
+			++cursor;
+			REQUIRE(*cursor == 2);
+		}
+
+		std::atomic<bool> stop = false;
+		std::thread eraser([&]() {
+			while (!list.empty()) {
+				list.pop_front();
+			}
+			stop = true;
+			});
+		while (!stop) {
+			int previous = -1;
+			for (auto cursor = list.scan(16); !cursor.done(); ++cursor) {
+				REQUIRE(previous < *cursor);
+				previous = *cursor;
+			}
+		}
+		eraser.join();
+		REQUIRE(list.empty());
+		REQUIRE(list.checklocks());
+	}
+	SECTION("CURSOR SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "CURSOR SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / ITERATOR / CURSOR (MILLION ELEMENTS PER SECOND)" << std::endl;
+
+		List<int> list;
+		int numberOfElements = 1000000;
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(i);
+		}
+
+		for (int threadsAmount = 1; threadsAmount <= 8; threadsAmount *= 2) {
+			auto run = [&](bool cursor) {
+				std::vector<std::thread> threads;
+				std::atomic<long long> total = 0;
+				auto start = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < threadsAmount; ++i) {
+					threads.push_back(std::thread([&]() {
+						long long sum = 0;
+						if (cursor) {
+							for (auto it = list.scan(); !it.done(); ++it) {
+								sum += *it;
+							}
+						}
+						else {
+							for (auto it = list.begin(); it != list.end(); ++it) {
+								sum += *it;
+							}
+						}
+						total += sum;
+						}));
+				}
+				for (auto& thread : threads) {
+					thread.join();
+				}
+				auto end = std::chrono::high_resolution_clock::now();
+				REQUIRE(total == static_cast<long long>(numberOfElements) * (numberOfElements - 1) / 2 * threadsAmount);
+				return static_cast<double>(numberOfElements) * threadsAmount / std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+			};
+
+			auto iterated = run(false);
+			auto scanned = run(true);
+			std::cout << threadsAmount << "        " << iterated << "        " << scanned << std::endl;
+		}
+	}
+	SECTION("PARALLEL FOR_EACH/FIND TEST") {
+		std::cout << "PARALLEL FOR_EACH/FIND TEST" << std::endl;
+		List<int> list;
+		int numberOfElements = 10000;
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(i % 1000);
+		}
+
+		std::atomic<long long> sum = 0;
+		std::atomic<int> counted = 0;
+		list.parallel_for_each([&](int value) {
+			sum += value;
+			++counted;
+			}, 4);
+		REQUIRE(counted == numberOfElements);
+		REQUIRE(sum == 10 * 999 * 1000 / 2);
+
+		auto it = list.parallel_find([](int value) { return value == 500; }, 4);
+		REQUIRE(*it == 500);
+		--it;
+		REQUIRE(*it == 499);
+		REQUIRE(bool(--list.parallel_find([](int value) { return value == 999; }, 3) == list.at(998)));
+		REQUIRE(bool(list.parallel_find([](int value) { return value < 0; }, 4) == list.end()));
+
+		// Cut at the checkpoints at() left behind, which an insert does not drop.
+		list.push_front(-1);
+		counted = 0;
+		list.parallel_for_each([&](int) { ++counted; }, 4);
+		REQUIRE(counted == numberOfElements + 1);
+		list.pop_front();
+
+		// Calls made while the pool is busy run on their own thread.
+		std::vector<std::thread> callers;
+		std::vector<int> perCaller(3, 0);
+		for (int i = 0; i < 3; ++i) {
+			callers.push_back(std::thread([&, i]() {
+				std::atomic<int> seen = 0;
+				list.parallel_for_each([&](int) { ++seen; }, 4);
+				perCaller[i] = seen;
+				}));
+		}
+		for (auto& caller : callers) {
+			caller.join();
+		}
+		for (int seen : perCaller) {
+			REQUIRE(seen == numberOfElements);
+		}
+		counted = numberOfElements;
+
+		List<int> empty;
+		empty.parallel_for_each([&](int) { ++counted; }, 4);
+		REQUIRE(counted == numberOfElements);
+		REQUIRE(bool(empty.parallel_find([](int) { return true; }) == empty.end()));
+
+		std::thread eraser([&]() {
+			for (int i = 0; i < numberOfElements / 2; ++i) {
+				list.pop_front();
+				list.pop_back();
+			}
+			});
+		while (!list.empty()) {
+			std::atomic<int> seen = 0;
+			list.parallel_for_each([&](int) { ++seen; }, 4);
+			REQUIRE(seen <= numberOfElements);
+			list.parallel_find([](int value) { return value == 999; }, 4);
+			list.at(0);
+		}
+		eraser.join();
+		REQUIRE(list.checklocks());
+	}
+	SECTION("PARALLEL SCAN SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "PARALLEL SCAN SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / SERIAL CURSOR / FOR_EACH / FIND LAST / FOR_EACH AFTER INSERT (MILLION ELEMENTS PER SECOND, LIST JUST MUTATED)" << std::endl;
+
+		List<int> list;
+		int numberOfElements = 2000000;
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(i);
+		}
+
+		for (size_t threadsAmount = 1; threadsAmount <= 8; threadsAmount *= 2) {
+			auto rate = [&](auto start, auto end) {
+				return numberOfElements / static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+			};
+
+			long long serial = 0;
+			auto startSerial = std::chrono::high_resolution_clock::now();
+			for (auto it = list.scan(); !it.done(); ++it) {
+				if (*it % 1000 == 0) {
+					serial += *it;
+				}
+			}
+
+			list.pop_back();
+			list.push_back(numberOfElements - 1);
+			std::atomic<long long> total = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			list.parallel_for_each([&](int value) {
+				if (value % 1000 == 0) {
+					total += value;
+				}
+				}, threadsAmount);
+			auto middle = std::chrono::high_resolution_clock::now();
+			list.pop_back();
+			list.push_back(numberOfElements - 1);
+			auto startFind = std::chrono::high_resolution_clock::now();
+			auto it = list.parallel_find([&](int value) { return value == numberOfElements - 1; }, threadsAmount);
+			auto end = std::chrono::high_resolution_clock::now();
+			REQUIRE(*it == numberOfElements - 1);
+			REQUIRE(total == serial);
+
+			// Checkpoints taken before an insert still serve as cuts.
+			list.at(0);
+			list.push_back(numberOfElements);
+			std::atomic<long long> totalIndexed = 0;
+			auto startIndexed = std::chrono::high_resolution_clock::now();
+			list.parallel_for_each([&](int value) {
+				if (value % 1000 == 0) {
+					totalIndexed += value;
+				}
+				}, threadsAmount);
+			auto endIndexed = std::chrono::high_resolution_clock::now();
+			REQUIRE(totalIndexed == serial + numberOfElements);
+			list.pop_back();
+
+			std::cout << threadsAmount << "        " << rate(startSerial, start) << "        "
+				<< rate(start, middle) << "        " << rate(startFind, end) << "        "
+				<< rate(startIndexed, endIndexed) << std::endl;
+		}
+	}
+	SECTION("SORT TEST") {
+		std::cout << "SORT TEST" << std::endl;
+		List<int> list;
+		int numberOfElements = 100000;
+		std::minstd_rand random(7);
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(static_cast<int>(random() % 1000) * numberOfElements + i);
+		}
+		auto kept = list.begin();
+		int keptValue = *kept;
+
+		list.sort([&](int a, int b) { return a / numberOfElements < b / numberOfElements; }, 4);
+		int previous = -1;
+		size_t counted = 0;
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			REQUIRE(previous < *it);
+			previous = *it;
+			++counted;
+		}
+		REQUIRE(counted == list.size());
+		REQUIRE(*kept == keptValue);
+		REQUIRE(list.checklocks());
+
+		list.sort([](int a, int b) { return a % 7 < b % 7; }, 3);
+		int previousKey = -1;
+		int previousValue = -1;
+		counted = 0;
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			REQUIRE(previousKey <= *it % 7);
+			REQUIRE((previousKey < *it % 7 || previousValue < *it));
+			previousKey = *it % 7;
+			previousValue = *it;
+			++counted;
+		}
+		REQUIRE(counted == list.size());
+		REQUIRE(list.checklocks());
+
+		list.sort(std::greater<int>());
+		REQUIRE(*list.begin() == previous);
+		REQUIRE(*--list.end() < *list.at(numberOfElements / 2));
+		REQUIRE(bool(list.at(numberOfElements - 1) == --list.end()));
+
+		List<int> small{ 3, 1, 2 };
+		small.sort();
+		REQUIRE(*small.begin() == 1);
+		REQUIRE(*--small.end() == 3);
+		List<int> empty;
+		empty.sort();
+		REQUIRE(empty.empty());
+
+		std::thread writer([&]() {
+			for (int i = 0; i < 10000; ++i) {
+				list.push_back(-i);
+				list.pop_front();
+			}
+			});
+		for (int i = 0; i < 5; ++i) {
+			list.sort();
+		}
+		writer.join();
+		list.sort();
+		REQUIRE(list.size() == static_cast<size_t>(numberOfElements));
+		previous = *list.begin();
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			REQUIRE(previous <= *it);
+			previous = *it;
+		}
+		REQUIRE(list.checklocks());
+	}
+	SECTION("SORT SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "SORT SPEED TEST" << std::endl;
+		std::cout << "NUMBER OF THREADS / COPY+STD::SORT+REBUILD / LIST::SORT (MILLISECONDS)" << std::endl;
+
+		int numberOfElements = 1000000;
+		for (size_t threadsAmount = 1; threadsAmount <= 8; threadsAmount *= 2) {
+			std::minstd_rand random(11);
+			List<int> copied;
+			List<int> relinked;
+			for (int i = 0; i < numberOfElements; ++i) {
+				int value = static_cast<int>(random());
+				copied.push_back(value);
+				relinked.push_back(value);
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			std::vector<int> values;
+			values.reserve(numberOfElements);
+			for (auto it = copied.scan(); !it.done(); ++it) {
+				values.push_back(*it);
+			}
+			std::sort(values.begin(), values.end());
+			List<int> rebuilt;
+			rebuilt.append_range(values.begin(), values.end());
+			auto middle = std::chrono::high_resolution_clock::now();
+			relinked.sort(std::less<int>(), threadsAmount);
+			auto end = std::chrono::high_resolution_clock::now();
+			REQUIRE(*relinked.begin() == values.front());
+
+			std::cout << threadsAmount << "        "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << std::endl;
+		}
+	}
+	SECTION("REMOVE_IF/CLEAR TEST") {
+		std::cout << "REMOVE_IF/CLEAR TEST" << std::endl;
+		List<int> list;
+		int numberOfElements = 10000;
+		for (int i = 0; i < numberOfElements; ++i) {
+			list.push_back(i);
+		}
+
+		auto removedIt = list.at(10);
+		auto keptIt = list.at(11);
+		REQUIRE(list.remove_if([](int value) { return value % 2 == 0 || value % 10 == 5; }) == static_cast<size_t>(numberOfElements * 6 / 10));
+		REQUIRE(list.size() == static_cast<size_t>(numberOfElements * 4 / 10));
+		REQUIRE(*++removedIt == 11);
+		REQUIRE(*++keptIt == 13);
+		int previous = -1;
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			REQUIRE(*it % 2 == 1);
+			REQUIRE(*it % 10 != 5);
+			REQUIRE(previous < *it);
+			previous = *it;
+		}
+		REQUIRE(list.remove_if([](int) { return false; }) == 0);
+		REQUIRE(list.checklocks());
+
+		list.clear();
+		REQUIRE(list.empty());
+		REQUIRE(bool(list.begin() == list.end()));
+		REQUIRE(list.remove_if([](int) { return true; }) == 0);
+		list.push_back(1);
+		REQUIRE(*list.begin() == 1);
+
+		std::atomic<bool> stop = false;
+		std::thread writer([&]() {
+			for (int i = 0; i < numberOfElements; ++i) {
+				list.push_back(i);
+				if (i % 3 == 0) {
+					list.pop_front();
+				}
+			}
+			stop = true;
+			});
+		while (!stop) {
+			list.remove_if([](int value) { return value % 7 == 0; });
+		}
+		writer.join();
+		list.remove_if([](int value) { return value % 7 == 0; });
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			REQUIRE(*it % 7 != 0);
+		}
+		list.clear();
+		REQUIRE(list.size() == 0);
+		REQUIRE(list.checklocks());
+	}
+	SECTION("BULK REMOVAL SPEED TEST") {
+		std::cout << std::endl;
+		std::cout << "BULK REMOVAL SPEED TEST" << std::endl;
+		std::cout << "REMOVED / ERASE LOOP / REMOVE_IF (MILLISECONDS)" << std::endl;
+
+		int numberOfElements = 1000000;
+		for (int every = 1; every <= 4; every *= 2) {
+			List<int> erased;
+			List<int> removed;
+			for (int i = 0; i < numberOfElements; ++i) {
+				erased.push_back(i);
+				removed.push_back(i);
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (auto it = erased.begin(); it != erased.end();) {
+				auto next = it;
+				++next;
+				if (*it % every == 0) {
+					erased.erase(it);
+				}
+				it = next;
+			}
+			auto middle = std::chrono::high_resolution_clock::now();
+			removed.remove_if([&](int value) { return value % every == 0; });
+			auto end = std::chrono::high_resolution_clock::now();
+			REQUIRE(erased.size() == removed.size());
+
+			std::cout << "1/" << every << "        "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count() << "        "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << std::endl;
+		}
+	}
+}
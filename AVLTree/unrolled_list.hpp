@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include "epoch.hpp"
+#include "slab.hpp"
+#include "list.hpp"
+#include "simd.hpp"
+
+namespace fefu {
+
+	template <typename T, std::size_t K> class UnrolledList;
+
+	// Chunk of up to K values stored contiguously. count, the values and the
+	// links are guarded by lock; an unlinked chunk keeps its right link so an
+	// iterator standing on it can still move on.
+	template <typename T, std::size_t K>
+	class list_chunk {
+	private:
+		template <typename G, std::size_t C>
+		friend class UnrolledList;
+
+		template <typename G, std::size_t C>
+		friend class UnrolledIterator;
+
+		template <typename G>
+		friend class retire_list;
+
+		std::atomic<status> chunk_status;
+		std::size_t count = 0;
+		std::array<T, K> values;
+		list_chunk* left = nullptr, * right = nullptr;
+		std::size_t retire_epoch = 0;
+		list_chunk* retire_next = nullptr;
+		rw_lock lock;
+
+		list_chunk(status state) : chunk_status(state), values() {}
+
+		static void* operator new(std::size_t) {
+			return slab_pool<list_chunk>::allocate();
+		}
+
+		static void operator delete(void* pointer) {
+			slab_pool<list_chunk>::deallocate(pointer);
+		}
+
+		bool is_full() {
+			return count == K;
+		}
+
+		void insert_at(std::size_t index, const T& value) {
+			std::move_backward(values.begin() + index, values.begin() + count, values.begin() + count + 1);
+			values[index] = value;
+			++count;
+		}
+
+		void erase_at(std::size_t index) {
+			std::move(values.begin() + index + 1, values.begin() + count, values.begin() + index);
+			--count;
+		}
+
+		// Moves the upper half of a full chunk into an empty one.
+		void split_into(list_chunk* other) {
+			std::size_t half = count / 2;
+			std::move(values.begin() + half, values.begin() + count, other->values.begin());
+			other->count = count - half;
+			count = half;
+		}
+	};
+
+	// Positional iterator: a chunk and an index inside it. Like LockFreeIterator
+	// it stays inside an epoch for its lifetime, which keeps its chunk alive
+	// after the chunk has been emptied and unlinked. Concurrent inserts and
+	// erases in the same chunk shift the values under it.
+	template <typename T, std::size_t K>
+	class UnrolledIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type&;
+		using pointer = value_type*;
+
+		template <typename G, std::size_t C>
+		friend class UnrolledList;
+
+		UnrolledIterator(const UnrolledIterator& other) noexcept {
+			chunk = other.chunk;
+			index = other.index;
+			list = other.list;
+			epoch = list->domain.enter();
+		}
+
+		~UnrolledIterator() {
+			list->domain.exit(epoch);
+		}
+
+		UnrolledIterator& operator=(const UnrolledIterator& other) {
+			std::size_t entered = other.list->domain.enter();
+			list->domain.exit(epoch);
+			epoch = entered;
+			chunk = other.chunk;
+			index = other.index;
+			list = other.list;
+			return *this;
+		}
+
+		value_type operator*() const {
+			chunk->lock.rlock();
+			auto value = chunk->values[index];
+			chunk->lock.unlock();
+			return value;
+		}
+
+		value_type get() {
+			return **this;
+		}
+
+		void set(value_type new_value) {
+			chunk->lock.wlock();
+			chunk->values[index] = new_value;
+			chunk->lock.unlock();
+		}
+
+		UnrolledIterator& operator++() {
+			inner_plus();
+			return *this;
+		}
+
+		UnrolledIterator operator++(int) {
+			UnrolledIterator temp = *this;
+			inner_plus();
+			return temp;
+		}
+
+		bool operator==(const UnrolledIterator& other) {
+			return other.chunk == chunk && other.index == index;
+		}
+
+		bool operator!=(const UnrolledIterator& other) {
+			return !(*this == other);
+		}
+
+	private:
+		using chunk_type = list_chunk<value_type, K>;
+
+		chunk_type* chunk = nullptr;
+		std::size_t index = 0;
+		UnrolledList<T, K>* list;
+		std::size_t epoch;
+
+		void inner_plus() {
+			if (chunk->chunk_status == status::END) {
+				return;
+			}
+			chunk->lock.rlock();
+			if (index + 1 < chunk->count) {
+				++index;
+				chunk->lock.unlock();
+				return;
+			}
+			chunk_type* right = chunk->right;
+			chunk->lock.unlock();
+			chunk = list->first_filled(right);
+			index = 0;
+		}
+
+		UnrolledIterator(chunk_type* chunk, std::size_t index, UnrolledList<T, K>* list, std::size_t epoch) noexcept {
+			this->chunk = chunk;
+			this->index = index;
+			this->list = list;
+			this->epoch = epoch;
+		}
+	};
+
+	// List storing up to K values per node, so traversal and find stream
+	// through contiguous arrays instead of taking a cache miss per element;
+	// find and count compare a whole register of values at a time.
+	// Locking follows List at chunk granularity: a value is inserted or
+	// removed under its chunk's write lock, and links are changed under the
+	// locks of both neighbours taken left to right. A chunk emptied by erase
+	// is unlinked and freed through the epoch_domain. T must be default
+	// constructible.
+	template <typename T, std::size_t K = 32>
+	class UnrolledList {
+	public:
+		static_assert(K >= 2, "UnrolledList needs room for at least two values per chunk");
+
+		using size_type = std::size_t;
+		using list_type = T;
+		using value_type = list_chunk<list_type, K>;
+		using iterator = UnrolledIterator<list_type, K>;
+
+		template <typename G, std::size_t C>
+		friend class UnrolledIterator;
+
+		UnrolledList(std::initializer_list<list_type> list) : UnrolledList() {
+			for (auto it : list)
+				push_back(it);
+		}
+
+		UnrolledList() : domain(epoch_domain::instance()), retired(domain) {
+			last = new value_type(status::END);
+			root = new value_type(status::BEGIN);
+
+			last->left = root;
+			root->right = last;
+		}
+
+		~UnrolledList() {
+			value_type* current = root;
+			while (current) {
+				value_type* next = current->right;
+				delete current;
+				current = next;
+			}
+		}
+
+		bool empty() {
+			return list_size == 0;
+		}
+
+		size_type size() {
+			return list_size;
+		}
+
+		iterator begin() {
+			std::size_t epoch = domain.enter();
+			root->lock.rlock();
+			value_type* first = root->right;
+			root->lock.unlock();
+			return iterator(first_filled(first), 0, this, epoch);
+		}
+
+		iterator end() {
+			return iterator(last, 0, this, domain.enter());
+		}
+
+		void push_front(list_type value) {
+			root->lock.wlock();
+			value_type* right = root->right;
+			right->lock.wlock();
+
+			if (right != last && !right->is_full()) {
+				right->insert_at(0, value);
+			}
+			else {
+				link_between(root, right)->insert_at(0, value);
+			}
+			++list_size;
+
+			root->lock.unlock();
+			right->lock.unlock();
+		}
+
+		void push_back(list_type value) {
+			std::size_t epoch = domain.enter();
+			for (bool retry = true; retry;) {
+				last->lock.rlock();
+				value_type* left = last->left;
+				last->lock.unlock();
+
+				left->lock.wlock();
+				last->lock.wlock();
+
+				if (left->right == last && last->left == left) {
+					if (left != root && !left->is_full()) {
+						left->values[left->count++] = value;
+					}
+					else {
+						link_between(left, last)->insert_at(0, value);
+					}
+					++list_size;
+					retry = false;
+				}
+
+				left->lock.unlock();
+				last->lock.unlock();
+			}
+			domain.exit(epoch);
+		}
+
+		// Inserts right after the value the iterator points at. A full chunk is
+		// split in half first, with the new chunk linked to its right.
+		void insert(iterator& it, list_type value) {
+			value_type* chunk = it.chunk;
+			if (chunk->chunk_status == status::END) {
+				push_back(value);
+				return;
+			}
+
+			chunk->lock.wlock();
+			if (chunk->chunk_status == status::DELETED) {
+				chunk->lock.unlock();
+				return;
+			}
+
+			value_type* right = chunk->right;
+			right->lock.wlock();
+
+			std::size_t index = std::min(it.index + 1, chunk->count);
+			if (chunk->is_full()) {
+				value_type* upper = link_between(chunk, right);
+				chunk->split_into(upper);
+				if (index > chunk->count) {
+					upper->insert_at(index - chunk->count, value);
+				}
+				else {
+					chunk->insert_at(index, value);
+				}
+			}
+			else {
+				chunk->insert_at(index, value);
+			}
+			++list_size;
+
+			chunk->lock.unlock();
+			right->lock.unlock();
+		}
+
+		iterator find(list_type value) {
+			std::size_t epoch = domain.enter();
+			root->lock.rlock();
+			value_type* current = root->right;
+			root->lock.unlock();
+			while (current != last) {
+				current->lock.rlock();
+				std::size_t found = simd::find(current->values.data(), current->count, value);
+				bool hit = found != current->count;
+				value_type* right = current->right;
+				current->lock.unlock();
+				if (hit) {
+					return iterator(current, found, this, epoch);
+				}
+				current = right;
+			}
+			return iterator(last, 0, this, epoch);
+		}
+
+		size_type count(list_type value) {
+			std::size_t epoch = domain.enter();
+			root->lock.rlock();
+			value_type* current = root->right;
+			root->lock.unlock();
+			size_type found = 0;
+			while (current != last) {
+				current->lock.rlock();
+				found += simd::count(current->values.data(), current->count, value);
+				value_type* right = current->right;
+				current->lock.unlock();
+				current = right;
+			}
+			domain.exit(epoch);
+			return found;
+		}
+
+		// Removes the value under the iterator. Only the chunk's own lock is
+		// taken unless this empties the chunk, in which case it is unlinked
+		// under its neighbours' locks like a List node.
+		void erase(iterator it) {
+			value_type* chunk = it.chunk;
+			if (chunk->chunk_status != status::ACTIVE) {
+				return;
+			}
+
+			chunk->lock.wlock();
+			if (chunk->chunk_status == status::DELETED || it.index >= chunk->count) {
+				chunk->lock.unlock();
+				return;
+			}
+			if (chunk->count > 1) {
+				chunk->erase_at(it.index);
+				--list_size;
+				chunk->lock.unlock();
+				return;
+			}
+			chunk->lock.unlock();
+
+			for (bool retry = true; retry;) {
+				chunk->lock.rlock();
+				value_type* left = chunk->left;
+				value_type* right = chunk->right;
+				chunk->lock.unlock();
+
+				left->lock.wlock();
+				chunk->lock.wlock();
+				right->lock.wlock();
+
+				if (chunk->chunk_status == status::DELETED || it.index >= chunk->count) {
+					retry = false;
+				}
+				else if (left->right == chunk && right->left == chunk) {
+					chunk->erase_at(it.index);
+					--list_size;
+					if (chunk->count == 0) {
+						chunk->chunk_status = status::DELETED;
+						left->right = right;
+						right->left = left;
+						retired.retire(chunk);
+					}
+					retry = false;
+				}
+
+				left->lock.unlock();
+				chunk->lock.unlock();
+				right->lock.unlock();
+			}
+
+			if (retired.ready()) {
+				retired.collect();
+			}
+		}
+
+		bool checklocks() {
+			value_type* cur = root;
+			while (cur != last) {
+				if (!cur->lock.is_free()) {
+					return false;
+				}
+				cur = cur->right;
+			}
+			return true;
+		}
+
+	private:
+		value_type* root = nullptr;
+		value_type* last = nullptr;
+		epoch_domain& domain;
+		retire_list<value_type> retired;
+		std::atomic<size_type> list_size = 0;
+
+		// Both neighbours must be write-locked by the caller.
+		value_type* link_between(value_type* left, value_type* right) {
+			value_type* chunk = new value_type(status::ACTIVE);
+			chunk->left = left;
+			chunk->right = right;
+			left->right = chunk;
+			right->left = chunk;
+			return chunk;
+		}
+
+		// Skips chunks left empty or unlinked by a concurrent erase.
+		value_type* first_filled(value_type* current) {
+			while (current != last) {
+				current->lock.rlock();
+				value_type* right = current->right;
+				bool filled = current->count != 0 && current->chunk_status == status::ACTIVE;
+				current->lock.unlock();
+				if (filled) {
+					break;
+				}
+				current = right;
+			}
+			return current;
+		}
+	};
+}